@@ -0,0 +1,181 @@
+// @copyright_start
+// Copyright (c) 2018-2019 Cisco and/or its affiliates. All rights reserved.
+// @copyright_end
+
+#include <efm_json_reader.h>
+#include <efm_json_utils.h>
+#include <efm_json_writer.h>
+#include <efm_msgpack.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+const std::vector<std::string> default_corpus{
+  "corpus/subscription_update.json", "corpus/list_response.json", "corpus/invoke_table.json"};
+
+bool read_file(const std::string& name, std::string& content)
+{
+  std::ifstream file(name, std::ios::binary);
+  if (!file) {
+    return false;
+  }
+  std::ostringstream stream;
+  stream << file.rdbuf();
+  content = stream.str();
+  return true;
+}
+
+// Integral doubles beyond 2^53 (and floats beyond 2^24) must still be written with a decimal point or exponent, so
+// they are read back as Variant::Double and not as integers.
+bool check_number_round_trip()
+{
+  const std::vector<double> doubles{9007199254740992.0, 9007199254740994.0, -9007199254740994.0, 1e16, 1e17,
+    123456789012345678.0, 18446744073709551616.0, -9223372036854775808.0, 1e300, std::ldexp(1.0, 80)};
+  const std::vector<float> floats{16777216.0f, 16777218.0f, -16777218.0f, 3e9f, 1e10f, 1e30f};
+
+  cisco::efm_sdk::Variant::ArrayType array;
+  for (double value : doubles) {
+    array.emplace_back(value);
+  }
+  cisco::efm_sdk::Variant::MapType map;
+  map.emplace("doubles", cisco::efm_sdk::Variant(array));
+  map.emplace("floats", cisco::efm_sdk::Variant(floats));
+
+  std::string json;
+  cisco::efm_sdk::json::append_json(cisco::efm_sdk::Variant(map), json);
+  const cisco::efm_sdk::Variant parsed = cisco::efm_sdk::json::parse(json);
+
+  const auto& parsed_doubles = parsed["doubles"].as_array();
+  const auto& parsed_floats = parsed["floats"].as_array();
+  bool ok = parsed_doubles.size() == doubles.size() && parsed_floats.size() == floats.size();
+  for (std::size_t i = 0; ok && i < doubles.size(); ++i) {
+    ok = parsed_doubles[i].type() == cisco::efm_sdk::Variant::Double && parsed_doubles[i].as_double() == doubles[i];
+  }
+  // floats are written with the shortest digits of the float, so compare after narrowing
+  for (std::size_t i = 0; ok && i < floats.size(); ++i) {
+    ok = parsed_floats[i].type() == cisco::efm_sdk::Variant::Double &&
+         static_cast<float>(parsed_floats[i].as_double()) == floats[i];
+  }
+  if (!ok) {
+    std::cerr << "Error: numbers do not round trip as doubles: " << json << std::endl;
+  }
+  return ok;
+}
+
+template <typename Operation>
+double seconds_per_iteration(Operation operation)
+{
+  using clock = std::chrono::steady_clock;
+
+  std::size_t iterations = 0;
+  const auto start = clock::now();
+  auto elapsed = clock::duration::zero();
+  while (elapsed < std::chrono::seconds(1)) {
+    operation();
+    ++iterations;
+    elapsed = clock::now() - start;
+  }
+
+  return std::chrono::duration<double>(elapsed).count() / static_cast<double>(iterations);
+}
+
+template <typename Parse>
+double megabytes_per_second(const std::string& document, Parse parse)
+{
+  const double seconds = seconds_per_iteration([&document, &parse]() { parse(document); });
+  return static_cast<double>(document.size()) / seconds / (1024 * 1024);
+}
+
+void compare_encodings(const std::string& name, const cisco::efm_sdk::Variant& message)
+{
+  std::string json;
+  const double json_encode = seconds_per_iteration([&json, &message]() {
+    json.clear();
+    cisco::efm_sdk::json::append_json(message, json);
+  });
+  const double json_decode = seconds_per_iteration([&json]() { cisco::efm_sdk::json::parse(json); });
+
+  std::vector<unsigned char> msgpack;
+  const double msgpack_encode = seconds_per_iteration([&msgpack, &message]() {
+    msgpack.clear();
+    cisco::efm_sdk::msgpack::encode(message, msgpack);
+  });
+  const double msgpack_decode =
+    seconds_per_iteration([&msgpack]() { cisco::efm_sdk::msgpack::decode(msgpack.data(), msgpack.size()); });
+
+  std::cout << std::left << std::setw(36) << name << std::right << std::setw(12) << json.size() << std::setw(12)
+            << msgpack.size() << std::fixed << std::setprecision(1) << std::setw(10) << json_encode * 1e6 << " us"
+            << std::setw(9) << msgpack_encode * 1e6 << " us" << std::setw(9) << json_decode * 1e6 << " us"
+            << std::setw(9) << msgpack_decode * 1e6 << " us" << std::endl;
+}
+}
+
+int main(int argc, char* argv[])
+{
+  std::vector<std::string> files(argv + 1, argv + argc);
+  if (files.empty()) {
+    files = default_corpus;
+  }
+
+  if (!check_number_round_trip()) {
+    return EXIT_FAILURE;
+  }
+
+  std::cout << std::left << std::setw(36) << "document" << std::right << std::setw(12) << "bytes" << std::setw(18)
+            << "from_json_string" << std::setw(12) << "parse" << std::endl;
+
+  std::vector<std::pair<std::string, cisco::efm_sdk::Variant>> messages;
+  for (const auto& name : files) {
+    std::string document;
+    if (!read_file(name, document)) {
+      std::cerr << "Error: cannot read " << name << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    try {
+      cisco::efm_sdk::Variant message = cisco::efm_sdk::json::parse(document);
+      if (message != cisco::efm_sdk::json::from_json_string(document)) {
+        std::cerr << "Error: the parsers disagree on " << name << std::endl;
+        return EXIT_FAILURE;
+      }
+      auto encoded = cisco::efm_sdk::msgpack::encode(message);
+      if (cisco::efm_sdk::msgpack::decode(encoded.data(), encoded.size()) != message) {
+        std::cerr << "Error: MessagePack round trip differs on " << name << std::endl;
+        return EXIT_FAILURE;
+      }
+      messages.emplace_back(name, std::move(message));
+    } catch (const std::exception& ex) {
+      std::cerr << "Error: parsing " << name << " failed - " << ex.what() << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    const double reference = megabytes_per_second(
+      document, [](const std::string& doc) { return cisco::efm_sdk::json::from_json_string(doc); });
+    const double simd =
+      megabytes_per_second(document, [](const std::string& doc) { return cisco::efm_sdk::json::parse(doc); });
+
+    std::cout << std::left << std::setw(36) << name << std::right << std::setw(12) << document.size() << std::fixed
+              << std::setprecision(1) << std::setw(13) << reference << " MB/s" << std::setw(7) << simd << " MB/s"
+              << std::endl;
+  }
+
+  std::cout << std::endl
+            << std::left << std::setw(36) << "encoding (per message)" << std::right << std::setw(12) << "json"
+            << std::setw(12) << "msgpack" << std::setw(13) << "json enc" << std::setw(12) << "mp enc" << std::setw(12)
+            << "json dec" << std::setw(12) << "mp dec" << std::endl;
+  for (const auto& message : messages) {
+    compare_encodings(message.first, message.second);
+  }
+
+  return EXIT_SUCCESS;
+}
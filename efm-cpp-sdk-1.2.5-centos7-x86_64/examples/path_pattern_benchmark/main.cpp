@@ -0,0 +1,158 @@
+// @copyright_start
+// Copyright (c) 2018-2019 Cisco and/or its affiliates. All rights reserved.
+// @copyright_end
+
+#include <efm_node_path.h>
+#include <efm_path_pattern.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <regex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+const std::size_t node_count = 100000;
+const std::size_t pattern_count = 50;
+
+/// Creates the paths of a node tree as created at startup: plants, lines, devices and their values.
+std::vector<cisco::efm_sdk::NodePath> make_paths()
+{
+  static const char* const values[] = {"temperature", "pressure", "status", "speed", "counter"};
+
+  std::vector<cisco::efm_sdk::NodePath> paths;
+  paths.reserve(node_count);
+  for (std::size_t i = 0; paths.size() < node_count; ++i) {
+    const std::string device = "/plants/plant-" + std::to_string(i % 10) + "/line-" + std::to_string(i % 37) +
+                               "/device-" + std::to_string(i);
+    paths.emplace_back(device);
+    for (const char* value : values) {
+      if (paths.size() < node_count) {
+        paths.emplace_back(device + "/" + value);
+      }
+    }
+  }
+  return paths;
+}
+
+/// Creates patterns like the ones links register for node creation callbacks.
+std::vector<std::string> make_patterns()
+{
+  std::vector<std::string> patterns;
+  for (std::size_t i = 0; patterns.size() < pattern_count; ++i) {
+    switch (i % 5) {
+      case 0:
+        patterns.push_back("/plants/plant-" + std::to_string(i % 10) + "/*");
+        break;
+      case 1:
+        patterns.push_back("/plants/*/line-" + std::to_string(i) + "/*/temperature");
+        break;
+      case 2:
+        patterns.push_back("/plants/**/device-" + std::to_string(i * 97) + "/*");
+        break;
+      case 3:
+        patterns.push_back("/plants/plant-?/line-" + std::to_string(i % 37) + "/device-*" + std::to_string(i % 10));
+        break;
+      default:
+        patterns.push_back("/nodes/" + std::to_string(i) + "/*");
+        break;
+    }
+  }
+  return patterns;
+}
+
+/// Translates a pattern into a regular expression, the way every pattern is checked on its own. The expression has the
+/// segment based semantics of PathPatternMatcher, i.e. `*` does not match `/`.
+std::regex to_regex(const std::string& pattern)
+{
+  std::string expression;
+  for (std::size_t i = 0; i < pattern.size(); ++i) {
+    const char c = pattern[i];
+    if (c == '*' && i + 1 < pattern.size() && pattern[i + 1] == '*') {
+      // `/**` also matches no segment at all
+      expression.pop_back();
+      expression += "(/.*)?";
+      ++i;
+    } else if (c == '*') {
+      expression += "[^/]*";
+    } else if (c == '?') {
+      expression += "[^/]";
+    } else if (std::string("\\^$.|+()[]{}").find(c) != std::string::npos) {
+      expression += '\\';
+      expression += c;
+    } else {
+      expression += c;
+    }
+  }
+  return std::regex(expression, std::regex::optimize);
+}
+
+template <typename Match>
+double milliseconds(Match match, std::size_t& matches)
+{
+  const auto start = std::chrono::steady_clock::now();
+  matches = match();
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+}
+
+int main()
+{
+  const auto paths = make_paths();
+  const auto patterns = make_patterns();
+
+  std::vector<std::regex> expressions;
+  cisco::efm_sdk::PathPatternMatcher<std::size_t> matcher;
+  for (std::size_t i = 0; i < patterns.size(); ++i) {
+    expressions.push_back(to_regex(patterns[i]));
+    if (!matcher.insert(patterns[i], i)) {
+      std::cerr << "Error: invalid pattern " << patterns[i] << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::size_t regex_matches = 0;
+  const double regex_time = milliseconds(
+    [&paths, &expressions]() {
+      std::size_t matches = 0;
+      for (const auto& path : paths) {
+        for (const auto& expression : expressions) {
+          if (std::regex_match(path.to_string(), expression)) {
+            ++matches;
+          }
+        }
+      }
+      return matches;
+    },
+    regex_matches);
+
+  std::size_t trie_matches = 0;
+  const double trie_time = milliseconds(
+    [&paths, &matcher]() {
+      std::size_t matches = 0;
+      for (const auto& path : paths) {
+        matcher.match(path, [&matches](const std::string&, const std::size_t&) { ++matches; });
+      }
+      return matches;
+    },
+    trie_matches);
+
+  if (regex_matches != trie_matches) {
+    std::cerr << "Error: the matchers disagree (" << regex_matches << " vs " << trie_matches << " matches)"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << paths.size() << " nodes, " << patterns.size() << " patterns, " << trie_matches << " matches"
+            << std::endl
+            << std::fixed << std::setprecision(1) << std::setw(28) << std::left << "regex per pattern" << std::right
+            << std::setw(10) << regex_time << " ms" << std::endl
+            << std::setw(28) << std::left << "PathPatternMatcher" << std::right << std::setw(10) << trie_time << " ms"
+            << std::endl;
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,172 @@
+// @copyright_start
+// Copyright (c) 2018-2019 Cisco and/or its affiliates. All rights reserved.
+// @copyright_end
+
+#include <efm_compact_variant.h>
+#include <efm_json_utils.h>
+#include <efm_variant.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+const std::size_t subscriber_count = 1000;
+const std::vector<std::string> default_corpus{"../json_benchmark/corpus/subscription_update.json",
+                                              "../json_benchmark/corpus/list_response.json",
+                                              "../json_benchmark/corpus/invoke_table.json"};
+
+bool read_file(const std::string& name, std::string& content)
+{
+  std::ifstream file(name, std::ios::binary);
+  if (!file) {
+    return false;
+  }
+  std::ostringstream stream;
+  stream << file.rdbuf();
+  content = stream.str();
+  return true;
+}
+
+/// Creates a value as published by a device node: a few scalar fields and a map of channels with their readings.
+cisco::efm_sdk::Variant make_value()
+{
+  cisco::efm_sdk::Variant::MapType channels;
+  for (int channel = 0; channel < 16; ++channel) {
+    cisco::efm_sdk::Variant::ArrayType readings;
+    for (int i = 0; i < 8; ++i) {
+      readings.emplace_back(channel * 100.0 + i * 0.25);
+    }
+    channels.emplace("channel-" + std::to_string(channel),
+                     cisco::efm_sdk::Variant(cisco::efm_sdk::Variant::MapType{
+                       {"unit", cisco::efm_sdk::Variant("bar")},
+                       {"quality", cisco::efm_sdk::Variant(int32_t{192})},
+                       {"readings", cisco::efm_sdk::Variant(std::move(readings))}}));
+  }
+
+  return cisco::efm_sdk::Variant(cisco::efm_sdk::Variant::MapType{
+    {"device", cisco::efm_sdk::Variant("/plants/plant-1/line-7/device-42")},
+    {"status", cisco::efm_sdk::Variant("running")},
+    {"sequence", cisco::efm_sdk::Variant(int64_t{1234567})},
+    {"channels", cisco::efm_sdk::Variant(std::move(channels))}});
+}
+
+template <typename Operation>
+double seconds_per_iteration(Operation operation)
+{
+  using clock = std::chrono::steady_clock;
+
+  std::size_t iterations = 0;
+  const auto start = clock::now();
+  auto elapsed = clock::duration::zero();
+  while (elapsed < std::chrono::seconds(1)) {
+    operation();
+    ++iterations;
+    elapsed = clock::now() - start;
+  }
+
+  return std::chrono::duration<double>(elapsed).count() / static_cast<double>(iterations);
+}
+
+/// Hands the value to every subscriber, the way an update is queued once per subscription, and hashes each copy to
+/// detect unchanged values.
+template <typename Value>
+void fan_out(const Value& value, std::vector<Value>& queues, std::size_t& hash)
+{
+  queues.clear();
+  for (std::size_t i = 0; i < subscriber_count; ++i) {
+    queues.push_back(value);
+  }
+  for (const auto& queued : queues) {
+    hash += queued.hash();
+  }
+}
+
+template <typename Value>
+double measure(const Value& value, std::size_t& hash)
+{
+  std::vector<Value> queues;
+  queues.reserve(subscriber_count);
+  return seconds_per_iteration([&value, &queues, &hash]() { fan_out(value, queues, hash); });
+}
+
+/// Decodes and encodes a message with the JSON functions of the SDK library, once as Variant and once converted to
+/// and from a CompactVariant, whose maps are FlatMaps.
+bool compare_codec(const std::string& name)
+{
+  std::string document;
+  if (!read_file(name, document)) {
+    std::cerr << "Error: cannot read " << name << std::endl;
+    return false;
+  }
+
+  const cisco::efm_sdk::Variant message = cisco::efm_sdk::json::from_json_string(document);
+  const cisco::efm_sdk::CompactVariant compact(message);
+  if (compact.to_variant() != message) {
+    std::cerr << "Error: the conversion differs on " << name << std::endl;
+    return false;
+  }
+
+  const double variant_decode =
+    seconds_per_iteration([&document]() { cisco::efm_sdk::json::from_json_string(document); });
+  const double compact_decode = seconds_per_iteration(
+    [&document]() { cisco::efm_sdk::CompactVariant(cisco::efm_sdk::json::from_json_string(document)); });
+  const double variant_encode = seconds_per_iteration([&message]() { cisco::efm_sdk::json::to_json_string(message); });
+  const double compact_encode =
+    seconds_per_iteration([&compact]() { cisco::efm_sdk::json::to_json_string(compact.to_variant()); });
+
+  std::cout << std::left << std::setw(52) << name << std::right << std::fixed << std::setprecision(1)
+            << std::setw(10) << variant_decode * 1e6 << " us" << std::setw(9) << compact_decode * 1e6 << " us"
+            << std::setw(9) << variant_encode * 1e6 << " us" << std::setw(9) << compact_encode * 1e6 << " us"
+            << std::endl;
+  return true;
+}
+}
+
+int main(int argc, char* argv[])
+{
+  const cisco::efm_sdk::Variant value = make_value();
+  const cisco::efm_sdk::CompactVariant compact(value);
+  if (compact.to_variant() != value || compact.hash() != value.hash()) {
+    std::cerr << "Error: the variants disagree" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::size_t hash = 0;
+  const double variant = measure(value, hash);
+  const double compact_variant = measure(compact, hash);
+
+  std::cout << "fan-out of one value to " << subscriber_count << " subscribers (copy and hash per subscriber)"
+            << std::endl
+            << std::left << std::setw(16) << "type" << std::right << std::setw(8) << "bytes" << std::setw(16)
+            << "per fan-out" << std::endl
+            << std::fixed << std::setprecision(1) << std::left << std::setw(16) << "Variant" << std::right
+            << std::setw(8) << sizeof(cisco::efm_sdk::Variant) << std::setw(13) << variant * 1e6 << " us" << std::endl
+            << std::left << std::setw(16) << "CompactVariant" << std::right << std::setw(8)
+            << sizeof(cisco::efm_sdk::CompactVariant) << std::setw(13) << compact_variant * 1e6 << " us"
+            << std::endl
+            << "(checksum " << std::hex << hash << std::dec << ")" << std::endl;
+
+  std::vector<std::string> files(argv + 1, argv + argc);
+  if (files.empty()) {
+    files = default_corpus;
+  }
+
+  std::cout << std::endl
+            << std::left << std::setw(52) << "from_json_string / to_json_string" << std::right << std::setw(13)
+            << "Variant" << std::setw(12) << "Compact" << std::setw(12) << "Variant" << std::setw(12) << "Compact"
+            << std::endl;
+  for (const auto& name : files) {
+    if (!compare_codec(name)) {
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,526 @@
+// @copyright_start
+// Copyright (c) 2018-2019 Cisco and/or its affiliates. All rights reserved.
+// @copyright_end
+
+/// @file efm_flat_map.h
+
+#pragma once
+
+#include <efm_error_code.h>
+#include <efm_exception.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <map>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace cisco
+{
+namespace efm_sdk
+{
+
+/// @brief A sorted associative container which stores its elements contiguously in a vector.
+
+/// The FlatMap provides the commonly used part of the std::map interface. Lookups are done via a binary search on the
+/// sorted elements, which is considerably more cache friendly than walking the nodes of a tree for the small maps
+/// typically found in the DSA protocol. Appending keys in ascending order (e.g. when decoding a serialized map) does
+/// not need to move any elements. Inserting a single key out of order or erasing an element rebuilds the vector, so
+/// maps built from unsorted keys should be constructed from a range (or use FlatMap::insert with a range), which sorts
+/// all elements once.
+///
+/// Like std::map, the elements are of type `std::pair<const Key, T>`. Since the keys are const, the vector is rebuilt
+/// instead of moving elements within it: the keys are copied and the mapped values are moved. Unlike std::map,
+/// inserting or erasing elements invalidates all iterators and references into the map.
+/// @tparam Key The key type.
+/// @tparam T The mapped type.
+/// @tparam Compare The comparison function object for the keys.
+template <typename Key, typename T, typename Compare = std::less<Key>>
+class FlatMap
+{
+public:
+  /// Key type of the map
+  using key_type = Key;
+  /// Mapped type of the map
+  using mapped_type = T;
+  /// Element type of the map
+  using value_type = std::pair<const Key, T>;
+  /// Key comparison function object
+  using key_compare = Compare;
+  /// Underlying container type
+  using container_type = std::vector<value_type>;
+  /// Size type of the map
+  using size_type = typename container_type::size_type;
+  /// Difference type of the map
+  using difference_type = typename container_type::difference_type;
+  /// Reference to an element
+  using reference = value_type&;
+  /// Const reference to an element
+  using const_reference = const value_type&;
+  /// Iterator type
+  using iterator = typename container_type::iterator;
+  /// Const iterator type
+  using const_iterator = typename container_type::const_iterator;
+  /// Reverse iterator type
+  using reverse_iterator = typename container_type::reverse_iterator;
+  /// Const reverse iterator type
+  using const_reverse_iterator = typename container_type::const_reverse_iterator;
+
+  /// Constructs an empty map.
+  FlatMap() = default;
+
+  /// Constructs the map from the elements of the given range. The elements are sorted once, the range does not need
+  /// to be sorted. If a key occurs multiple times, the first element will be used.
+  /// @tparam InputIt The input iterator type.
+  /// @param first The start of the range.
+  /// @param last The end of the range.
+  template <typename InputIt>
+  FlatMap(InputIt first, InputIt last)
+  {
+    insert(first, last);
+  }
+
+  /// Constructs the map from an initializer list. If a key occurs multiple times, the first element will be used.
+  /// @param init The elements to initialize the map with.
+  FlatMap(std::initializer_list<value_type> init)
+    : FlatMap(init.begin(), init.end())
+  {
+  }
+
+  /// Constructs the map from a std::map. Allows existing code working with std::map to interface with this map.
+  /// @param other The std::map to copy the elements from.
+  FlatMap(const std::map<Key, T, Compare>& other)
+    : elements_(other.begin(), other.end())
+  {
+  }
+
+  /// Converts the map to a std::map. Allows existing code working with std::map to interface with this map.
+  /// @return A std::map with the elements of this map.
+  operator std::map<Key, T, Compare>() const
+  {
+    return std::map<Key, T, Compare>(elements_.begin(), elements_.end());
+  }
+
+  /// Returns an iterator to the first element.
+  /// @return An iterator to the first element.
+  iterator begin() noexcept
+  {
+    return elements_.begin();
+  }
+
+  /// Returns an iterator to the first element.
+  /// @return An iterator to the first element.
+  const_iterator begin() const noexcept
+  {
+    return elements_.begin();
+  }
+
+  /// Returns an iterator to the first element.
+  /// @return An iterator to the first element.
+  const_iterator cbegin() const noexcept
+  {
+    return elements_.cbegin();
+  }
+
+  /// Returns an iterator past the last element.
+  /// @return An iterator past the last element.
+  iterator end() noexcept
+  {
+    return elements_.end();
+  }
+
+  /// Returns an iterator past the last element.
+  /// @return An iterator past the last element.
+  const_iterator end() const noexcept
+  {
+    return elements_.end();
+  }
+
+  /// Returns an iterator past the last element.
+  /// @return An iterator past the last element.
+  const_iterator cend() const noexcept
+  {
+    return elements_.cend();
+  }
+
+  /// Returns a reverse iterator to the last element.
+  /// @return A reverse iterator to the last element.
+  reverse_iterator rbegin() noexcept
+  {
+    return elements_.rbegin();
+  }
+
+  /// Returns a reverse iterator to the last element.
+  /// @return A reverse iterator to the last element.
+  const_reverse_iterator rbegin() const noexcept
+  {
+    return elements_.rbegin();
+  }
+
+  /// Returns a reverse iterator before the first element.
+  /// @return A reverse iterator before the first element.
+  reverse_iterator rend() noexcept
+  {
+    return elements_.rend();
+  }
+
+  /// Returns a reverse iterator before the first element.
+  /// @return A reverse iterator before the first element.
+  const_reverse_iterator rend() const noexcept
+  {
+    return elements_.rend();
+  }
+
+  /// Checks if the map is empty.
+  /// @return true if the map has no elements, otherwise false.
+  bool empty() const noexcept
+  {
+    return elements_.empty();
+  }
+
+  /// Returns the number of elements.
+  /// @return The number of elements.
+  size_type size() const noexcept
+  {
+    return elements_.size();
+  }
+
+  /// Reserves storage for the given number of elements.
+  /// @param n The number of elements to reserve storage for.
+  void reserve(size_type n)
+  {
+    if (n > elements_.capacity()) {
+      container_type elements;
+      elements.reserve(n);
+      move_elements(0, elements_.size(), elements);
+      elements_.swap(elements);
+    }
+  }
+
+  /// Removes all elements.
+  void clear() noexcept
+  {
+    elements_.clear();
+  }
+
+  /// Returns a reference to the mapped value of the given key. Inserts a default constructed value if the key does not
+  /// exist yet.
+  /// @param key The key of the element.
+  /// @return A reference to the mapped value.
+  T& operator[](const Key& key)
+  {
+    return try_emplace(key).first->second;
+  }
+
+  /// Returns a reference to the mapped value of the given key. Inserts a default constructed value if the key does not
+  /// exist yet.
+  /// @param key The key of the element.
+  /// @return A reference to the mapped value.
+  T& operator[](Key&& key)
+  {
+    return try_emplace(std::move(key)).first->second;
+  }
+
+  /// Returns a reference to the mapped value of the given key.
+  /// @throw cisco::efm_sdk::exception If the key does not exist.
+  /// @param key The key of the element.
+  /// @return A reference to the mapped value.
+  T& at(const Key& key)
+  {
+    auto it = find(key);
+    if (it == end()) {
+      throw exception(error_code::efm_variant_error, "key not found");
+    }
+    return it->second;
+  }
+
+  /// Returns a reference to the mapped value of the given key.
+  /// @throw cisco::efm_sdk::exception If the key does not exist.
+  /// @param key The key of the element.
+  /// @return A reference to the mapped value.
+  const T& at(const Key& key) const
+  {
+    auto it = find(key);
+    if (it == end()) {
+      throw exception(error_code::efm_variant_error, "key not found");
+    }
+    return it->second;
+  }
+
+  /// Inserts an element if its key does not exist yet.
+  /// @param value The element to insert.
+  /// @return A pair of the iterator to the element with the key and true if the element was inserted.
+  std::pair<iterator, bool> insert(const value_type& value)
+  {
+    return try_emplace(value.first, value.second);
+  }
+
+  /// Inserts an element if its key does not exist yet.
+  /// @param value The element to insert.
+  /// @return A pair of the iterator to the element with the key and true if the element was inserted.
+  std::pair<iterator, bool> insert(value_type&& value)
+  {
+    return try_emplace(value.first, std::move(value.second));
+  }
+
+  /// Inserts the elements of the given range whose keys do not exist yet. The new elements are sorted once and merged
+  /// with the existing ones, the range does not need to be sorted. If a key occurs multiple times in the range, the
+  /// first element will be used.
+  /// @tparam InputIt The input iterator type.
+  /// @param first The start of the range.
+  /// @param last The end of the range.
+  template <typename InputIt>
+  void insert(InputIt first, InputIt last)
+  {
+    std::vector<std::pair<Key, T>> added;
+    for (; first != last; ++first) {
+      added.emplace_back(*first);
+    }
+    if (!std::is_sorted(added.begin(), added.end(), ElementCompare{comp_})) {
+      // stable, so the first of several elements with the same key is kept
+      std::stable_sort(added.begin(), added.end(), ElementCompare{comp_});
+    }
+    added.erase(
+      std::unique(
+        added.begin(),
+        added.end(),
+        [this](const std::pair<Key, T>& lhs, const std::pair<Key, T>& rhs) { return !comp_(lhs.first, rhs.first); }),
+      added.end());
+
+    container_type elements;
+    elements.reserve(elements_.size() + added.size());
+    auto existing = elements_.begin();
+    for (auto it = added.begin(); it != added.end(); ++it) {
+      for (; existing != elements_.end() && comp_(existing->first, it->first); ++existing) {
+        elements.emplace_back(std::move(*existing));
+      }
+      if (existing != elements_.end() && !comp_(it->first, existing->first)) {
+        continue;
+      }
+      elements.emplace_back(std::move(it->first), std::move(it->second));
+    }
+    for (; existing != elements_.end(); ++existing) {
+      elements.emplace_back(std::move(*existing));
+    }
+    elements_.swap(elements);
+  }
+
+  /// Constructs an element in-place if its key does not exist yet.
+  /// @param args The arguments to construct the element from.
+  /// @return A pair of the iterator to the element with the key and true if the element was inserted.
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args)
+  {
+    return insert(value_type(std::forward<Args>(args)...));
+  }
+
+  /// Constructs the mapped value in-place if the key does not exist yet.
+  /// @param key The key of the element.
+  /// @param args The arguments to construct the mapped value from.
+  /// @return A pair of the iterator to the element with the key and true if the element was inserted.
+  template <typename K, typename... Args>
+  std::pair<iterator, bool> try_emplace(K&& key, Args&&... args)
+  {
+    // keys arriving in ascending order are simply appended
+    if (elements_.empty() || comp_(elements_.back().first, key)) {
+      if (elements_.size() == elements_.capacity()) {
+        return {insert_at(elements_.size(), std::forward<K>(key), std::forward<Args>(args)...), true};
+      }
+      elements_.emplace_back(
+        std::piecewise_construct,
+        std::forward_as_tuple(std::forward<K>(key)),
+        std::forward_as_tuple(std::forward<Args>(args)...));
+      return {std::prev(elements_.end()), true};
+    }
+
+    auto it = lower_bound(key);
+    if (it != end() && !comp_(key, it->first)) {
+      return {it, false};
+    }
+    return {insert_at(static_cast<size_type>(it - begin()), std::forward<K>(key), std::forward<Args>(args)...), true};
+  }
+
+  /// Removes the element at the given position.
+  /// @param pos The position of the element to remove.
+  /// @return The iterator following the removed element.
+  iterator erase(const_iterator pos)
+  {
+    return erase(pos, std::next(pos));
+  }
+
+  /// Removes the elements of the given range.
+  /// @param first The start of the range.
+  /// @param last The end of the range.
+  /// @return The iterator following the last removed element.
+  iterator erase(const_iterator first, const_iterator last)
+  {
+    const auto pos = static_cast<size_type>(first - cbegin());
+    const auto end_pos = static_cast<size_type>(last - cbegin());
+    if (end_pos == elements_.size()) {
+      while (elements_.size() > pos) {
+        elements_.pop_back();
+      }
+      return end();
+    }
+
+    container_type elements;
+    elements.reserve(elements_.capacity());
+    move_elements(0, pos, elements);
+    move_elements(end_pos, elements_.size(), elements);
+    elements_.swap(elements);
+    return begin() + static_cast<difference_type>(pos);
+  }
+
+  /// Removes the element with the given key if it exists.
+  /// @param key The key of the element to remove.
+  /// @return The number of removed elements (0 or 1).
+  size_type erase(const Key& key)
+  {
+    auto it = find(key);
+    if (it == end()) {
+      return 0;
+    }
+    erase(it);
+    return 1;
+  }
+
+  /// Swaps the content with another map.
+  /// @param other The map to swap the content with.
+  void swap(FlatMap& other) noexcept
+  {
+    elements_.swap(other.elements_);
+  }
+
+  /// Returns the number of elements with the given key.
+  /// @param key The key to search for.
+  /// @return 1 if the key exists, otherwise 0.
+  size_type count(const Key& key) const
+  {
+    return find(key) == end() ? 0 : 1;
+  }
+
+  /// Finds the element with the given key.
+  /// @param key The key to search for.
+  /// @return The iterator to the element or end() if the key does not exist.
+  iterator find(const Key& key)
+  {
+    auto it = lower_bound(key);
+    return (it != end() && !comp_(key, it->first)) ? it : end();
+  }
+
+  /// Finds the element with the given key.
+  /// @param key The key to search for.
+  /// @return The iterator to the element or end() if the key does not exist.
+  const_iterator find(const Key& key) const
+  {
+    auto it = lower_bound(key);
+    return (it != end() && !comp_(key, it->first)) ? it : end();
+  }
+
+  /// Returns the first element whose key is not less than the given key.
+  /// @param key The key to compare to.
+  /// @return The iterator to the element or end() if there is no such element.
+  iterator lower_bound(const Key& key)
+  {
+    return std::lower_bound(elements_.begin(), elements_.end(), key, KeyCompare{comp_});
+  }
+
+  /// Returns the first element whose key is not less than the given key.
+  /// @param key The key to compare to.
+  /// @return The iterator to the element or end() if there is no such element.
+  const_iterator lower_bound(const Key& key) const
+  {
+    return std::lower_bound(elements_.begin(), elements_.end(), key, KeyCompare{comp_});
+  }
+
+  /// Returns the first element whose key is greater than the given key.
+  /// @param key The key to compare to.
+  /// @return The iterator to the element or end() if there is no such element.
+  iterator upper_bound(const Key& key)
+  {
+    auto it = lower_bound(key);
+    return (it != end() && !comp_(key, it->first)) ? std::next(it) : it;
+  }
+
+  /// Returns the first element whose key is greater than the given key.
+  /// @param key The key to compare to.
+  /// @return The iterator to the element or end() if there is no such element.
+  const_iterator upper_bound(const Key& key) const
+  {
+    auto it = lower_bound(key);
+    return (it != end() && !comp_(key, it->first)) ? std::next(it) : it;
+  }
+
+  /// Compares two maps for equality.
+  /// @param lhs The first map to compare.
+  /// @param rhs The other map to compare.
+  /// @return true if both maps contain the same elements, otherwise false.
+  friend bool operator==(const FlatMap& lhs, const FlatMap& rhs)
+  {
+    return lhs.elements_ == rhs.elements_;
+  }
+
+  /// Compares two maps for inequality.
+  /// @param lhs The first map to compare.
+  /// @param rhs The other map to compare.
+  /// @return true if the maps do not contain the same elements, otherwise false.
+  friend bool operator!=(const FlatMap& lhs, const FlatMap& rhs)
+  {
+    return lhs.elements_ != rhs.elements_;
+  }
+
+private:
+  struct KeyCompare
+  {
+    bool operator()(const value_type& lhs, const Key& rhs) const
+    {
+      return comp_(lhs.first, rhs);
+    }
+
+    const Compare& comp_;
+  };
+
+  struct ElementCompare
+  {
+    bool operator()(const std::pair<Key, T>& lhs, const std::pair<Key, T>& rhs) const
+    {
+      return comp_(lhs.first, rhs.first);
+    }
+
+    const Compare& comp_;
+  };
+
+  // moves the elements [first, last) to the end of the target, the keys are const and therefore copied
+  void move_elements(size_type first, size_type last, container_type& target)
+  {
+    for (size_type i = first; i < last; ++i) {
+      target.emplace_back(std::move(elements_[i]));
+    }
+  }
+
+  // inserts an element before the given position by rebuilding the vector, elements with const keys cannot be moved
+  // within a vector
+  template <typename K, typename... Args>
+  iterator insert_at(size_type pos, K&& key, Args&&... args)
+  {
+    container_type elements;
+    elements.reserve(std::max<size_type>(2 * elements_.size(), 4));
+    move_elements(0, pos, elements);
+    elements.emplace_back(
+      std::piecewise_construct,
+      std::forward_as_tuple(std::forward<K>(key)),
+      std::forward_as_tuple(std::forward<Args>(args)...));
+    move_elements(pos, elements_.size(), elements);
+    elements_.swap(elements);
+    return begin() + static_cast<difference_type>(pos);
+  }
+
+  container_type elements_;
+  Compare comp_;
+};
+}
+}
@@ -0,0 +1,529 @@
+// @copyright_start
+// Copyright (c) 2018-2019 Cisco and/or its affiliates. All rights reserved.
+// @copyright_end
+
+/// @file efm_json_reader.h
+
+#pragma once
+
+#include <efm_error_code.h>
+#include <efm_exception.h>
+#include <efm_variant.h>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#if defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+/// Defined if the JSON reader uses SSE4.2 and AVX2 (selected at runtime).
+#define EFM_SDK_JSON_SIMD 1
+#include <immintrin.h>
+#endif
+#endif
+
+namespace cisco
+{
+namespace efm_sdk
+{
+namespace json
+{
+/// @private
+namespace detail
+{
+/// The maximum nesting depth of arrays and maps.
+static const int max_depth = 512;
+
+/// Returns the first character which ends the plain part of a JSON string: a quote, a backslash or a control
+/// character. Returns end if there is none.
+inline const char* scan_string_scalar(const char* p, const char* end)
+{
+  for (; p != end; ++p) {
+    const unsigned char c = static_cast<unsigned char>(*p);
+    if (c == '"' || c == '\\' || c < 0x20) {
+      break;
+    }
+  }
+  return p;
+}
+
+#ifdef EFM_SDK_JSON_SIMD
+__attribute__((target("sse4.2"))) inline const char* scan_string_sse42(const char* p, const char* end)
+{
+  alignas(16) static const char ranges[16] = {'\0', '\x1F', '"', '"', '\\', '\\'};
+  const __m128i r = _mm_load_si128(reinterpret_cast<const __m128i*>(ranges));
+  for (; end - p >= 16; p += 16) {
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const int i = _mm_cmpestri(r, 6, chunk, 16, _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_LEAST_SIGNIFICANT);
+    if (i != 16) {
+      return p + i;
+    }
+  }
+  return scan_string_scalar(p, end);
+}
+
+__attribute__((target("avx2"))) inline const char* scan_string_avx2(const char* p, const char* end)
+{
+  const __m256i quote = _mm256_set1_epi8('"');
+  const __m256i backslash = _mm256_set1_epi8('\\');
+  const __m256i control = _mm256_set1_epi8(0x1F);
+  for (; end - p >= 32; p += 32) {
+    const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    const __m256i special = _mm256_or_si256(
+      _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, backslash)),
+      _mm256_cmpeq_epi8(_mm256_max_epu8(chunk, control), control));
+    const unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(special));
+    if (mask != 0) {
+      return p + __builtin_ctz(mask);
+    }
+  }
+  return scan_string_scalar(p, end);
+}
+#endif
+
+/// @private
+using ScanFunction = const char* (*)(const char*, const char*);
+
+/// Selects the fastest string scanner supported by the CPU.
+inline ScanFunction select_scan_string()
+{
+#ifdef EFM_SDK_JSON_SIMD
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return &scan_string_avx2;
+  }
+  if (__builtin_cpu_supports("sse4.2")) {
+    return &scan_string_sse42;
+  }
+#endif
+  return &scan_string_scalar;
+}
+
+inline const char* scan_string(const char* p, const char* end)
+{
+  static const ScanFunction scan = select_scan_string();
+  return scan(p, end);
+}
+
+inline void append_utf8(uint32_t code_point, std::string& out)
+{
+  if (code_point < 0x80) {
+    out += static_cast<char>(code_point);
+  } else if (code_point < 0x800) {
+    out += static_cast<char>(0xC0 | (code_point >> 6));
+    out += static_cast<char>(0x80 | (code_point & 0x3F));
+  } else if (code_point < 0x10000) {
+    out += static_cast<char>(0xE0 | (code_point >> 12));
+    out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (code_point & 0x3F));
+  } else {
+    out += static_cast<char>(0xF0 | (code_point >> 18));
+    out += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+    out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (code_point & 0x3F));
+  }
+}
+
+/// @brief The tokenizer shared by the JSON parsers.
+class Scanner
+{
+public:
+  /// @param offset The offset of the data in the document, used in error messages.
+  Scanner(const char* data, std::size_t size, std::size_t offset = 0)
+    : begin_(data)
+    , p_(data)
+    , end_(data + size)
+    , offset_(offset)
+  {
+  }
+
+  [[noreturn]] void fail(const char* what) const
+  {
+    throw exception(
+      error_code::invalid_value,
+      std::string("invalid JSON at offset ") + std::to_string(offset_ + static_cast<std::size_t>(p_ - begin_)) + ": " +
+        what);
+  }
+
+  const char* position() const
+  {
+    return p_;
+  }
+
+  std::size_t remaining() const
+  {
+    return static_cast<std::size_t>(end_ - p_);
+  }
+
+  /// Skips whitespace and returns the next character or 0 at the end of the input.
+  char peek()
+  {
+    while (p_ != end_ && (*p_ == ' ' || *p_ == '\n' || *p_ == '\r' || *p_ == '\t')) {
+      ++p_;
+    }
+    return p_ != end_ ? *p_ : '\0';
+  }
+
+  void expect(char c)
+  {
+    if (peek() != c) {
+      fail("unexpected character");
+    }
+    ++p_;
+  }
+
+  /// Consumes the character if it is the next one.
+  bool consume(char c)
+  {
+    if (peek() == c) {
+      ++p_;
+      return true;
+    }
+    return false;
+  }
+
+  bool at_end()
+  {
+    return peek() == '\0' && p_ == end_;
+  }
+
+  void literal(const char* text, std::size_t length)
+  {
+    if (static_cast<std::size_t>(end_ - p_) < length || std::string::traits_type::compare(p_, text, length) != 0) {
+      fail("invalid literal");
+    }
+    p_ += length;
+  }
+
+  /// Reads a string, the opening quote has to be the next character.
+  void string(std::string& out)
+  {
+    if (!try_string(out)) {
+      p_ = end_;
+      fail("unterminated string");
+    }
+  }
+
+  /// Reads a string, the opening quote has to be the next character. Returns false without consuming anything if the
+  /// input ends before the closing quote.
+  bool try_string(std::string& out)
+  {
+    const char* start = p_;
+    expect('"');
+    out.clear();
+    for (;;) {
+      const char* stop = scan_string(p_, end_);
+      out.append(p_, stop);
+      p_ = stop;
+      if (p_ == end_) {
+        p_ = start;
+        return false;
+      }
+      const char c = *p_++;
+      if (c == '"') {
+        return true;
+      }
+      if (c != '\\') {
+        --p_;
+        fail("control character in string");
+      }
+      if (!escape(out)) {
+        p_ = start;
+        return false;
+      }
+    }
+  }
+
+  /// Returns true if the input continues after the number starting at the current position.
+  bool number_terminated() const
+  {
+    for (const char* p = p_; p != end_; ++p) {
+      if ((*p < '0' || *p > '9') && *p != '-' && *p != '+' && *p != '.' && *p != 'e' && *p != 'E') {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// Reads a number into the variant.
+  Variant number()
+  {
+    const char* start = p_;
+    const bool negative = p_ != end_ && *p_ == '-';
+    if (negative) {
+      ++p_;
+    }
+    if (p_ == end_ || *p_ < '0' || *p_ > '9') {
+      fail("invalid number");
+    }
+
+    uint64_t mantissa = 0;
+    int digits = 0;
+    bool overflow = false;
+    if (*p_ == '0') {
+      ++p_;
+    } else {
+      for (; p_ != end_ && *p_ >= '0' && *p_ <= '9'; ++p_, ++digits) {
+        const uint64_t digit = static_cast<uint64_t>(*p_ - '0');
+        if (mantissa > (UINT64_MAX - digit) / 10) {
+          overflow = true;
+        }
+        mantissa = mantissa * 10 + digit;
+      }
+    }
+
+    int exponent = 0;
+    bool integral = true;
+    if (p_ != end_ && *p_ == '.') {
+      integral = false;
+      ++p_;
+      if (p_ == end_ || *p_ < '0' || *p_ > '9') {
+        fail("invalid number");
+      }
+      for (; p_ != end_ && *p_ >= '0' && *p_ <= '9'; ++p_) {
+        if (digits < 19) {
+          mantissa = mantissa * 10 + static_cast<uint64_t>(*p_ - '0');
+          --exponent;
+          if (mantissa != 0) {
+            ++digits;
+          }
+        }
+      }
+    }
+    if (p_ != end_ && (*p_ == 'e' || *p_ == 'E')) {
+      integral = false;
+      ++p_;
+      bool negative_exponent = false;
+      if (p_ != end_ && (*p_ == '+' || *p_ == '-')) {
+        negative_exponent = *p_ == '-';
+        ++p_;
+      }
+      if (p_ == end_ || *p_ < '0' || *p_ > '9') {
+        fail("invalid number");
+      }
+      int value = 0;
+      for (; p_ != end_ && *p_ >= '0' && *p_ <= '9'; ++p_) {
+        if (value < 100000) {
+          value = value * 10 + (*p_ - '0');
+        }
+      }
+      exponent += negative_exponent ? -value : value;
+    }
+
+    if (integral && !overflow) {
+      if (!negative) {
+        if (mantissa <= static_cast<uint64_t>(INT64_MAX)) {
+          return Variant(static_cast<int64_t>(mantissa));
+        }
+        return Variant(mantissa);
+      }
+      if (mantissa <= static_cast<uint64_t>(INT64_MAX) + 1) {
+        return Variant(static_cast<int64_t>(0 - mantissa));
+      }
+    }
+
+    static const double powers_of_ten[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                           1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    double value;
+    if (!overflow && mantissa <= (uint64_t(1) << 53) && exponent >= -22 && exponent <= 22) {
+      // both operands are exact, so the result is correctly rounded
+      value = static_cast<double>(mantissa);
+      value = exponent < 0 ? value / powers_of_ten[-exponent] : value * powers_of_ten[exponent];
+      if (negative) {
+        value = -value;
+      }
+    } else {
+      value = std::strtod(std::string(start, p_).c_str(), nullptr);
+    }
+    if (!std::isfinite(value)) {
+      fail("number out of range");
+    }
+    return Variant(value);
+  }
+
+private:
+  uint32_t hex4()
+  {
+    if (end_ - p_ < 4) {
+      fail("invalid unicode escape");
+    }
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i, ++p_) {
+      const char c = *p_;
+      value <<= 4;
+      if (c >= '0' && c <= '9') {
+        value |= static_cast<uint32_t>(c - '0');
+      } else if (c >= 'a' && c <= 'f') {
+        value |= static_cast<uint32_t>(c - 'a' + 10);
+      } else if (c >= 'A' && c <= 'F') {
+        value |= static_cast<uint32_t>(c - 'A' + 10);
+      } else {
+        fail("invalid unicode escape");
+      }
+    }
+    return value;
+  }
+
+  // Returns true if the input ends within the next length characters and the string is not terminated before.
+  bool truncated(std::size_t length) const
+  {
+    const std::size_t available = remaining();
+    return available < length && std::string::traits_type::find(p_, available, '"') == nullptr;
+  }
+
+  // Returns false if the input ends within the escape sequence.
+  bool escape(std::string& out)
+  {
+    if (p_ == end_) {
+      return false;
+    }
+    switch (*p_++) {
+      case '"':
+        out += '"';
+        break;
+      case '\\':
+        out += '\\';
+        break;
+      case '/':
+        out += '/';
+        break;
+      case 'b':
+        out += '\b';
+        break;
+      case 'f':
+        out += '\f';
+        break;
+      case 'n':
+        out += '\n';
+        break;
+      case 'r':
+        out += '\r';
+        break;
+      case 't':
+        out += '\t';
+        break;
+      case 'u': {
+        if (truncated(4)) {
+          return false;
+        }
+        uint32_t code_point = hex4();
+        if (code_point >= 0xD800 && code_point <= 0xDBFF) {
+          if (truncated(6)) {
+            return false;
+          }
+          if (p_[0] != '\\' || p_[1] != 'u') {
+            fail("invalid surrogate pair");
+          }
+          p_ += 2;
+          const uint32_t low = hex4();
+          if (low < 0xDC00 || low > 0xDFFF) {
+            fail("invalid surrogate pair");
+          }
+          code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+        } else if (code_point >= 0xDC00 && code_point <= 0xDFFF) {
+          fail("invalid surrogate pair");
+        }
+        append_utf8(code_point, out);
+        break;
+      }
+      default:
+        --p_;
+        fail("invalid escape");
+    }
+    return true;
+  }
+
+  const char* begin_;
+  const char* p_;
+  const char* end_;
+  std::size_t offset_;
+};
+
+inline Variant parse_value(Scanner& scanner, int depth)
+{
+  if (depth > max_depth) {
+    scanner.fail("nesting too deep");
+  }
+
+  switch (scanner.peek()) {
+    case '{': {
+      scanner.expect('{');
+      std::vector<std::pair<std::string, Variant>> members;
+      if (!scanner.consume('}')) {
+        std::string key;
+        do {
+          scanner.string(key);
+          scanner.expect(':');
+          Variant value = parse_value(scanner, depth + 1);
+          members.emplace_back(std::move(key), std::move(value));
+        } while (scanner.consume(','));
+        scanner.expect('}');
+      }
+      return Variant(efm_sdk::detail::make_map(std::move(members)));
+    }
+    case '[': {
+      scanner.expect('[');
+      Variant::ArrayType array;
+      if (!scanner.consume(']')) {
+        do {
+          array.push_back(parse_value(scanner, depth + 1));
+        } while (scanner.consume(','));
+        scanner.expect(']');
+      }
+      return Variant(std::move(array));
+    }
+    case '"': {
+      std::string s;
+      scanner.string(s);
+      return Variant(std::move(s));
+    }
+    case 't':
+      scanner.literal("true", 4);
+      return Variant(true);
+    case 'f':
+      scanner.literal("false", 5);
+      return Variant(false);
+    case 'n':
+      scanner.literal("null", 4);
+      return Variant();
+    default:
+      return scanner.number();
+  }
+}
+}
+
+/// Parses a JSON document into a Variant. Integers are stored as Variant::Int (Variant::UInt if they exceed the range
+/// of int64_t), other numbers as Variant::Double.
+///
+/// The parser is header only and an alternative to cisco::efm_sdk::json::from_json_string, which is implemented in
+/// the SDK library and does not use it. On x86 CPUs the strings are scanned with AVX2 or SSE4.2, depending on the
+/// support of the CPU, which is detected at runtime. Otherwise a scalar implementation is used.
+/// @throw cisco::efm_sdk::exception If the data is not a valid JSON document.
+/// @param data The JSON document.
+/// @param size The size of the JSON document.
+/// @return The parsed Variant.
+inline Variant parse(const char* data, std::size_t size)
+{
+  detail::Scanner scanner(data, size);
+  Variant value = detail::parse_value(scanner, 0);
+  if (!scanner.at_end()) {
+    scanner.fail("trailing characters");
+  }
+  return value;
+}
+
+/// Parses a JSON document into a Variant, see cisco::efm_sdk::json::parse(const char*, std::size_t).
+/// @throw cisco::efm_sdk::exception If the string is not a valid JSON document.
+/// @param str The JSON document.
+/// @return The parsed Variant.
+inline Variant parse(const std::string& str)
+{
+  return parse(str.data(), str.size());
+}
+}
+}
+}
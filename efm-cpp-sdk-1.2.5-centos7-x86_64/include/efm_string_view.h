@@ -0,0 +1,264 @@
+// @copyright_start
+// Copyright (c) 2018-2019 Cisco and/or its affiliates. All rights reserved.
+// @copyright_end
+
+/// @file efm_string_view.h
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <ostream>
+#include <string>
+
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+
+namespace cisco
+{
+namespace efm_sdk
+{
+
+/// @brief A non owning view of a sequence of characters.
+
+/// The subset of `std::string_view` the SDK needs, available in C++11. The viewed characters have to outlive the
+/// view. Compiled as C++17 a StringView converts from and to `std::string_view`.
+class StringView
+{
+public:
+  /// the iterator type
+  using const_iterator = const char*;
+  /// the size type
+  using size_type = std::size_t;
+
+  /// Returned by the find functions if the character is not found.
+  static const size_type npos = static_cast<size_type>(-1);
+
+  /// Constructs an empty view.
+  StringView() noexcept = default;
+
+  /// Constructs a view of a character sequence.
+  /// @param data The first character.
+  /// @param size The number of characters.
+  StringView(const char* data, size_type size) noexcept
+    : data_(data)
+    , size_(size)
+  {
+  }
+
+  /// Constructs a view of a null terminated c string.
+  /// @param data The c string.
+  StringView(const char* data) noexcept
+    : data_(data)
+    , size_(std::strlen(data))
+  {
+  }
+
+  /// Constructs a view of a string.
+  /// @param s The string.
+  StringView(const std::string& s) noexcept
+    : data_(s.data())
+    , size_(s.size())
+  {
+  }
+
+#if __cplusplus >= 201703L
+  /// Constructs a view of a std::string_view.
+  /// @param s The string view.
+  StringView(std::string_view s) noexcept
+    : data_(s.data())
+    , size_(s.size())
+  {
+  }
+
+  /// Converts the view to a std::string_view.
+  /// @return The std::string_view of the same characters.
+  operator std::string_view() const noexcept
+  {
+    return std::string_view(data_, size_);
+  }
+#endif
+
+  /// Returns the viewed characters, which are not null terminated.
+  /// @return A pointer to the first character.
+  const char* data() const noexcept
+  {
+    return data_;
+  }
+
+  /// Returns the number of characters.
+  /// @return The number of characters.
+  size_type size() const noexcept
+  {
+    return size_;
+  }
+
+  /// Checks if the view is empty.
+  /// @return true if the view is empty, otherwise false.
+  bool empty() const noexcept
+  {
+    return size_ == 0;
+  }
+
+  /// Returns the start iterator.
+  /// @return An iterator to the first character.
+  const_iterator begin() const noexcept
+  {
+    return data_;
+  }
+
+  /// Returns the end iterator.
+  /// @return An iterator past the last character.
+  const_iterator end() const noexcept
+  {
+    return data_ + size_;
+  }
+
+  /// Returns a character of the view.
+  /// @param i The index of the character, has to be less than the size.
+  /// @return The character.
+  char operator[](size_type i) const noexcept
+  {
+    return data_[i];
+  }
+
+  /// Returns a part of the view.
+  /// @param pos The index of the first character. Is limited to the size.
+  /// @param count The maximum number of characters.
+  /// @return The view of the part.
+  StringView substr(size_type pos, size_type count = npos) const noexcept
+  {
+    pos = std::min(pos, size_);
+    return StringView(data_ + pos, std::min(count, size_ - pos));
+  }
+
+  /// Finds the first occurrence of a character.
+  /// @param c The character to find.
+  /// @param pos The index to start searching at.
+  /// @return The index of the character or StringView::npos.
+  size_type find(char c, size_type pos = 0) const noexcept
+  {
+    if (pos >= size_) {
+      return npos;
+    }
+    const void* found = std::memchr(data_ + pos, c, size_ - pos);
+    return found == nullptr ? npos : static_cast<size_type>(static_cast<const char*>(found) - data_);
+  }
+
+  /// Finds the last occurrence of a character.
+  /// @param c The character to find.
+  /// @param pos The index to start searching backwards at.
+  /// @return The index of the character or StringView::npos.
+  size_type rfind(char c, size_type pos = npos) const noexcept
+  {
+    if (size_ == 0) {
+      return npos;
+    }
+    for (size_type i = std::min(pos, size_ - 1) + 1; i > 0; --i) {
+      if (data_[i - 1] == c) {
+        return i - 1;
+      }
+    }
+    return npos;
+  }
+
+  /// Checks if the view starts with the given characters.
+  /// @param prefix The characters to check for.
+  /// @return true if the view starts with the prefix, otherwise false.
+  bool starts_with(StringView prefix) const noexcept
+  {
+    return size_ >= prefix.size_ && compare_chars(data_, prefix.data_, prefix.size_) == 0;
+  }
+
+  /// Compares the view lexicographically to another one.
+  /// @param other The view to compare to.
+  /// @return A negative value, zero or a positive value if this view is less than, equal to or greater than the other.
+  int compare(StringView other) const noexcept
+  {
+    const int result = compare_chars(data_, other.data_, std::min(size_, other.size_));
+    if (result != 0) {
+      return result;
+    }
+    return size_ < other.size_ ? -1 : (size_ > other.size_ ? 1 : 0);
+  }
+
+  /// Copies the viewed characters into a string.
+  /// @return The string.
+  std::string to_string() const
+  {
+    return std::string(data_, size_);
+  }
+
+  /// Compares two views for equality.
+  /// @param lhs The first view to compare.
+  /// @param rhs The other view to compare.
+  /// @return true if the views have the same characters, false otherwise
+  friend bool operator==(StringView lhs, StringView rhs) noexcept
+  {
+    return lhs.size_ == rhs.size_ && compare_chars(lhs.data_, rhs.data_, lhs.size_) == 0;
+  }
+
+  /// Compares two views for inequality.
+  /// @param lhs The first view to compare.
+  /// @param rhs The other view to compare.
+  /// @return true if the views have different characters, false otherwise
+  friend bool operator!=(StringView lhs, StringView rhs) noexcept
+  {
+    return !(lhs == rhs);
+  }
+
+  /// Compares two views lexicographically.
+  /// @param lhs The first view to compare.
+  /// @param rhs The other view to compare.
+  /// @return true if the left view is lexicographically smaller than the right one, otherwise false.
+  friend bool operator<(StringView lhs, StringView rhs) noexcept
+  {
+    return lhs.compare(rhs) < 0;
+  }
+
+  /// Computes a hash value for StringView. The hash is FNV-1a, the same in C++11 and C++17 builds, it differs from
+  /// `std::hash<std::string>` of the same characters.
+  struct Hash
+  {
+    /// Computes a hash value for StringView.
+    /// @param view The view to compute the hash for.
+    /// @return The computed hash.
+    std::size_t operator()(StringView view) const noexcept
+    {
+      std::size_t hash = sizeof(std::size_t) == 8 ? static_cast<std::size_t>(14695981039346656037ULL) : 2166136261U;
+      const std::size_t prime = sizeof(std::size_t) == 8 ? static_cast<std::size_t>(1099511628211ULL) : 16777619U;
+      for (char c : view) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * prime;
+      }
+      return hash;
+    }
+  };
+
+private:
+  // memcmp must not be called with a null pointer, not even for zero characters
+  static int compare_chars(const char* lhs, const char* rhs, size_type count) noexcept
+  {
+    return count == 0 ? 0 : std::memcmp(lhs, rhs, count);
+  }
+
+  const char* data_{nullptr};
+  size_type size_{0};
+};
+
+/// stream insertion operator for StringView
+///
+/// @tparam CharT Character type for the ostream
+/// @tparam Traits Traits to be used by the ostream
+/// @param os the stream to insert the object into
+/// @param view the StringView object to insert
+/// @return the std::basic_ostream object
+template <class CharT, class Traits>
+std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, StringView view)
+{
+  return os.write(view.data(), static_cast<std::streamsize>(view.size()));
+}
+}
+}
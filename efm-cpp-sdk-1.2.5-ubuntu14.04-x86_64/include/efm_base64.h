@@ -0,0 +1,383 @@
+// @copyright_start
+// Copyright (c) 2018-2019 Cisco and/or its affiliates. All rights reserved.
+// @copyright_end
+
+/// @file efm_base64.h
+
+#pragma once
+
+#include <efm_error_code.h>
+#include <efm_exception.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#if defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+/// Defined if Base64 encoding and decoding use SSSE3 and AVX2 (selected at runtime).
+#define EFM_SDK_BASE64_SIMD 1
+#include <immintrin.h>
+#endif
+#endif
+
+namespace cisco
+{
+namespace efm_sdk
+{
+namespace base64
+{
+/// @private
+namespace detail
+{
+static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/// Maps characters to their 6 bit value, invalid characters are mapped to 0xFF.
+struct DecodeTable
+{
+  DecodeTable()
+  {
+    for (unsigned char& value : values_) {
+      value = 0xFF;
+    }
+    for (unsigned char i = 0; i < 64; ++i) {
+      values_[static_cast<unsigned char>(alphabet[i])] = i;
+    }
+  }
+
+  unsigned char values_[256];
+};
+
+inline const unsigned char* decode_table()
+{
+  static const DecodeTable table;
+  return table.values_;
+}
+
+inline unsigned char decode_char(char c)
+{
+  return decode_table()[static_cast<unsigned char>(c)];
+}
+
+[[noreturn]] inline void invalid_character(std::size_t offset)
+{
+  throw exception(error_code::invalid_value, "invalid Base64 character at offset " + std::to_string(offset));
+}
+
+/// Encodes the complete groups of 3 bytes, returns the number of bytes encoded.
+inline std::size_t encode_scalar(const unsigned char* data, std::size_t size, char* out)
+{
+  std::size_t i = 0;
+  for (; i + 3 <= size; i += 3) {
+    const unsigned int n = (data[i] << 16) | (data[i + 1] << 8) | data[i + 2];
+    *out++ = alphabet[(n >> 18) & 0x3F];
+    *out++ = alphabet[(n >> 12) & 0x3F];
+    *out++ = alphabet[(n >> 6) & 0x3F];
+    *out++ = alphabet[n & 0x3F];
+  }
+  return i;
+}
+
+/// Decodes the complete groups of 4 characters, returns the number of characters decoded.
+inline std::size_t decode_scalar(const char* data, std::size_t size, unsigned char* out)
+{
+  const unsigned char* values = decode_table();
+  std::size_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    const unsigned char a = values[static_cast<unsigned char>(data[i])];
+    const unsigned char b = values[static_cast<unsigned char>(data[i + 1])];
+    const unsigned char c = values[static_cast<unsigned char>(data[i + 2])];
+    const unsigned char d = values[static_cast<unsigned char>(data[i + 3])];
+    if ((a | b | c | d) & 0x80) {
+      break;
+    }
+    const unsigned int n = (a << 18) | (b << 12) | (c << 6) | d;
+    *out++ = static_cast<unsigned char>(n >> 16);
+    *out++ = static_cast<unsigned char>(n >> 8);
+    *out++ = static_cast<unsigned char>(n);
+  }
+  return i;
+}
+
+#ifdef EFM_SDK_BASE64_SIMD
+// The vector code follows the algorithms of W. Mula and D. Lemire ("Faster Base64 Encoding and Decoding Using AVX2
+// Instructions"): bytes are split into 6 bit indices by shuffles and multiplications and translated to characters with
+// a 16 entry lookup of offsets (and vice versa).
+
+__attribute__((target("ssse3"))) inline __m128i encode_lookup_ssse3(__m128i indices)
+{
+  const __m128i offsets = _mm_setr_epi8(
+    'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+    '+' - 62, '/' - 63, 'A', 0, 0);
+  // 0..25 -> 13, 26..51 -> 0, 52..61 -> 1..10, 62 -> 11, 63 -> 12
+  __m128i selector = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+  const __m128i upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+  selector = _mm_or_si128(selector, _mm_and_si128(upper, _mm_set1_epi8(13)));
+  return _mm_add_epi8(_mm_shuffle_epi8(offsets, selector), indices);
+}
+
+__attribute__((target("ssse3"))) inline std::size_t encode_ssse3(const unsigned char* data, std::size_t size, char* out)
+{
+  const __m128i shuffle = _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+  std::size_t i = 0;
+  // every iteration loads 16 bytes and encodes 12 of them
+  for (; i + 16 <= size; i += 12, out += 16) {
+    __m128i in = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), shuffle);
+    const __m128i hi = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040));
+    const __m128i lo = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), encode_lookup_ssse3(_mm_or_si128(hi, lo)));
+  }
+  return i + encode_scalar(data + i, size - i, out);
+}
+
+__attribute__((target("avx2"))) inline std::size_t encode_avx2(const unsigned char* data, std::size_t size, char* out)
+{
+  const __m256i shuffle = _mm256_setr_epi8(
+    1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10, 1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+  const __m256i offsets = _mm256_setr_epi8(
+    'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+    '+' - 62, '/' - 63, 'A', 0, 0, 'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+    '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+  std::size_t i = 0;
+  // every iteration loads 2 x 16 bytes and encodes 2 x 12 of them
+  for (; i + 28 <= size; i += 24, out += 32) {
+    const __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    const __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 12));
+    __m256i in = _mm256_inserti128_si256(_mm256_castsi128_si256(first), second, 1);
+    in = _mm256_shuffle_epi8(in, shuffle);
+    const __m256i hi =
+      _mm256_mulhi_epu16(_mm256_and_si256(in, _mm256_set1_epi32(0x0FC0FC00)), _mm256_set1_epi32(0x04000040));
+    const __m256i lo =
+      _mm256_mullo_epi16(_mm256_and_si256(in, _mm256_set1_epi32(0x003F03F0)), _mm256_set1_epi32(0x01000010));
+    const __m256i indices = _mm256_or_si256(hi, lo);
+    __m256i selector = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+    const __m256i upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+    selector = _mm256_or_si256(selector, _mm256_and_si256(upper, _mm256_set1_epi8(13)));
+    _mm256_storeu_si256(
+      reinterpret_cast<__m256i*>(out), _mm256_add_epi8(_mm256_shuffle_epi8(offsets, selector), indices));
+  }
+  return i + encode_ssse3(data + i, size - i, out);
+}
+
+__attribute__((target("ssse3"))) inline std::size_t decode_ssse3(const char* data, std::size_t size, unsigned char* out)
+{
+  const __m128i lut_lo =
+    _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+  const __m128i lut_hi =
+    _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+  const __m128i lut_roll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+  const __m128i pack = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+  std::size_t i = 0;
+  // every iteration decodes 16 characters and stores 16 bytes of which 12 are valid. The output for the remaining 8
+  // characters (at least 4 bytes) leaves room for the 4 extra bytes.
+  for (; i + 24 <= size; i += 16, out += 12) {
+    const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    const __m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(in, 4), _mm_set1_epi8(0x0F));
+    const __m128i lo_nibbles = _mm_and_si128(in, _mm_set1_epi8(0x0F));
+    const __m128i lo = _mm_shuffle_epi8(lut_lo, lo_nibbles);
+    const __m128i hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+    if (_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128())) != 0) {
+      break;
+    }
+    const __m128i slash = _mm_cmpeq_epi8(in, _mm_set1_epi8('/'));
+    const __m128i values = _mm_add_epi8(in, _mm_shuffle_epi8(lut_roll, _mm_add_epi8(slash, hi_nibbles)));
+    const __m128i pairs = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    const __m128i triples = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_shuffle_epi8(triples, pack));
+  }
+  return i + decode_scalar(data + i, size - i, out);
+}
+
+__attribute__((target("avx2"))) inline std::size_t decode_avx2(const char* data, std::size_t size, unsigned char* out)
+{
+  const __m256i lut_lo = _mm256_setr_epi8(
+    0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A, 0x15, 0x11, 0x11,
+    0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+  const __m256i lut_hi = _mm256_setr_epi8(
+    0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x01,
+    0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+  const __m256i lut_roll = _mm256_setr_epi8(
+    0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0, 0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+  const __m256i pack = _mm256_setr_epi8(
+    2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1, 2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+  const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+  std::size_t i = 0;
+  // every iteration decodes 32 characters and stores 32 bytes of which 24 are valid
+  for (; i + 48 <= size; i += 32, out += 24) {
+    const __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+    const __m256i hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(in, 4), _mm256_set1_epi8(0x0F));
+    const __m256i lo_nibbles = _mm256_and_si256(in, _mm256_set1_epi8(0x0F));
+    const __m256i lo = _mm256_shuffle_epi8(lut_lo, lo_nibbles);
+    const __m256i hi = _mm256_shuffle_epi8(lut_hi, hi_nibbles);
+    if (!_mm256_testz_si256(lo, hi)) {
+      break;
+    }
+    const __m256i slash = _mm256_cmpeq_epi8(in, _mm256_set1_epi8('/'));
+    const __m256i values = _mm256_add_epi8(in, _mm256_shuffle_epi8(lut_roll, _mm256_add_epi8(slash, hi_nibbles)));
+    const __m256i pairs = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+    const __m256i triples = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+    const __m256i packed = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(triples, pack), lanes);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), packed);
+  }
+  return i + decode_ssse3(data + i, size - i, out);
+}
+#endif
+
+using EncodeFunction = std::size_t (*)(const unsigned char*, std::size_t, char*);
+using DecodeFunction = std::size_t (*)(const char*, std::size_t, unsigned char*);
+
+/// Selects the fastest encoder supported by the CPU.
+inline EncodeFunction select_encode()
+{
+#ifdef EFM_SDK_BASE64_SIMD
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return &encode_avx2;
+  }
+  if (__builtin_cpu_supports("ssse3")) {
+    return &encode_ssse3;
+  }
+#endif
+  return &encode_scalar;
+}
+
+/// Selects the fastest decoder supported by the CPU.
+inline DecodeFunction select_decode()
+{
+#ifdef EFM_SDK_BASE64_SIMD
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return &decode_avx2;
+  }
+  if (__builtin_cpu_supports("ssse3")) {
+    return &decode_ssse3;
+  }
+#endif
+  return &decode_scalar;
+}
+
+/// Returns the number of characters of the encoding without padding.
+inline std::size_t strip_padding(const char* data, std::size_t size)
+{
+  for (int i = 0; i < 2 && size > 0 && data[size - 1] == '='; ++i) {
+    --size;
+  }
+  return size;
+}
+}
+
+/// Returns the length of the Base64 encoding (including padding) of the given number of bytes.
+/// @param size The number of bytes to encode.
+/// @return The length of the encoding.
+inline std::size_t encoded_size(std::size_t size)
+{
+  return ((size + 2) / 3) * 4;
+}
+
+/// Returns the number of bytes a Base64 encoding decodes to. Missing padding is accepted.
+/// @throw cisco::efm_sdk::exception If the length of the encoding is invalid.
+/// @param data The encoding.
+/// @param size The length of the encoding.
+/// @return The number of decoded bytes.
+inline std::size_t decoded_size(const char* data, std::size_t size)
+{
+  const std::size_t length = detail::strip_padding(data, size);
+  if (length % 4 == 1) {
+    throw exception(error_code::invalid_value, "invalid Base64 length");
+  }
+  return length / 4 * 3 + (length % 4 == 0 ? 0 : length % 4 - 1);
+}
+
+/// Encodes the given bytes to Base64 (with padding) into a caller supplied buffer. Uses AVX2 or SSSE3 if supported by
+/// the CPU.
+/// @param data The bytes to encode.
+/// @param size The number of bytes to encode.
+/// @param out The buffer to write to. Has to provide at least base64::encoded_size(size) characters.
+/// @return A pointer past the last written character.
+inline char* encode(const unsigned char* data, std::size_t size, char* out)
+{
+  static const detail::EncodeFunction encode_groups = detail::select_encode();
+
+  const std::size_t i = encode_groups(data, size, out);
+  out += i / 3 * 4;
+  if (i < size) {
+    const unsigned int n = (data[i] << 16) | (i + 1 < size ? data[i + 1] << 8 : 0);
+    *out++ = detail::alphabet[(n >> 18) & 0x3F];
+    *out++ = detail::alphabet[(n >> 12) & 0x3F];
+    *out++ = i + 1 < size ? detail::alphabet[(n >> 6) & 0x3F] : '=';
+    *out++ = '=';
+  }
+  return out;
+}
+
+/// Encodes the given bytes to Base64 (with padding) and appends the encoding to the string.
+/// @param data The bytes to encode.
+/// @param size The number of bytes to encode.
+/// @param out The string to append the encoding to.
+inline void encode(const unsigned char* data, std::size_t size, std::string& out)
+{
+  const std::size_t pos = out.size();
+  out.resize(pos + encoded_size(size));
+  encode(data, size, &out[pos]);
+}
+
+/// Decodes Base64 into a caller supplied buffer. Missing padding is accepted. Uses AVX2 or SSSE3 if supported by the
+/// CPU.
+/// @throw cisco::efm_sdk::exception If the encoding contains invalid characters or has an invalid length.
+/// @param data The encoding.
+/// @param size The length of the encoding.
+/// @param out The buffer to write to. Has to provide at least base64::decoded_size(data, size) bytes.
+/// @return A pointer past the last written byte.
+inline unsigned char* decode(const char* data, std::size_t size, unsigned char* out)
+{
+  static const detail::DecodeFunction decode_groups = detail::select_decode();
+
+  const std::size_t length = detail::strip_padding(data, size);
+  if (length % 4 == 1) {
+    throw exception(error_code::invalid_value, "invalid Base64 length");
+  }
+
+  const std::size_t i = decode_groups(data, length, out);
+  out += i / 4 * 3;
+  if (length - i >= 4) {
+    // the vector or scalar loop stopped at an invalid character
+    for (std::size_t j = i; j < length; ++j) {
+      if (detail::decode_char(data[j]) == 0xFF) {
+        detail::invalid_character(j);
+      }
+    }
+  }
+
+  unsigned int n = 0;
+  const std::size_t rest = length - i;
+  for (std::size_t j = 0; j < rest; ++j) {
+    const unsigned char value = detail::decode_char(data[i + j]);
+    if (value == 0xFF) {
+      detail::invalid_character(i + j);
+    }
+    n |= value << (18 - 6 * j);
+  }
+  if (rest >= 2) {
+    *out++ = static_cast<unsigned char>(n >> 16);
+  }
+  if (rest == 3) {
+    *out++ = static_cast<unsigned char>(n >> 8);
+  }
+  return out;
+}
+
+/// Decodes Base64 and appends the bytes to a vector. Missing padding is accepted.
+/// @throw cisco::efm_sdk::exception If the encoding contains invalid characters or has an invalid length.
+/// @param data The encoding.
+/// @param size The length of the encoding.
+/// @param out The vector to append the decoded bytes to.
+inline void decode(const char* data, std::size_t size, std::vector<unsigned char>& out)
+{
+  const std::size_t pos = out.size();
+  out.resize(pos + decoded_size(data, size));
+  decode(data, size, out.data() + pos);
+}
+}
+}
+}
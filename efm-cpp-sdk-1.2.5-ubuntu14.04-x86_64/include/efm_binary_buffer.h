@@ -0,0 +1,132 @@
+// @copyright_start
+// Copyright (c) 2018-2019 Cisco and/or its affiliates. All rights reserved.
+// @copyright_end
+
+/// @file efm_binary_buffer.h
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace cisco
+{
+namespace efm_sdk
+{
+
+/// @brief An immutable, shared buffer of bytes.
+
+/// The buffer either owns its bytes or references memory owned by the caller. In the latter case the caller hands over
+/// an owner object, which is kept alive as long as any copy of the buffer exists. No bytes are copied in this case.
+/// Copying a BinaryBuffer never copies the bytes.
+class BinaryBuffer
+{
+public:
+  /// Constructs an empty buffer.
+  BinaryBuffer() = default;
+
+  /// Constructs a buffer owning the given bytes. The bytes are moved into the buffer.
+  /// @param bytes The bytes of the buffer.
+  BinaryBuffer(std::vector<unsigned char>&& bytes)
+  {
+    auto owned = std::make_shared<std::vector<unsigned char>>(std::move(bytes));
+    data_ = owned->data();
+    size_ = owned->size();
+    owner_ = std::move(owned);
+  }
+
+  /// Constructs a buffer owning a copy of the given bytes.
+  /// @param data The bytes to copy.
+  /// @param size The number of bytes to copy.
+  BinaryBuffer(const unsigned char* data, std::size_t size)
+    : BinaryBuffer(std::vector<unsigned char>(data, data + size))
+  {
+  }
+
+  /// Constructs a buffer referencing memory owned by the caller. No bytes are copied. The memory has to stay valid
+  /// and unchanged as long as the owner is alive.
+  ///
+  /// @code
+  ///     std::shared_ptr<Frame> frame = camera.snapshot();
+  ///     cisco::efm_sdk::BinaryBuffer buffer(frame->data(), frame->size(), frame);
+  /// @endcode
+  ///
+  /// @param data The bytes to reference.
+  /// @param size The number of bytes to reference.
+  /// @param owner The owner of the memory. Will be kept alive as long as the buffer or one of its copies exists.
+  BinaryBuffer(const unsigned char* data, std::size_t size, std::shared_ptr<const void> owner)
+    : owner_(std::move(owner))
+    , data_(data)
+    , size_(size)
+  {
+  }
+
+  /// Returns the bytes of the buffer.
+  /// @return A pointer to the first byte of the buffer.
+  const unsigned char* data() const noexcept
+  {
+    return data_;
+  }
+
+  /// Returns the number of bytes of the buffer.
+  /// @return The number of bytes.
+  std::size_t size() const noexcept
+  {
+    return size_;
+  }
+
+  /// Checks if the buffer is empty.
+  /// @return true if the buffer has no bytes, otherwise false.
+  bool empty() const noexcept
+  {
+    return size_ == 0;
+  }
+
+  /// Returns the start iterator for the bytes of the buffer.
+  /// @return Start iterator for the bytes of the buffer.
+  const unsigned char* begin() const noexcept
+  {
+    return data_;
+  }
+
+  /// Returns the end iterator for the bytes of the buffer.
+  /// @return End iterator for the bytes of the buffer.
+  const unsigned char* end() const noexcept
+  {
+    return data_ + size_;
+  }
+
+  /// Copies the bytes of the buffer into a vector.
+  /// @return A vector with a copy of the bytes.
+  std::vector<unsigned char> to_vector() const
+  {
+    return std::vector<unsigned char>(begin(), end());
+  }
+
+  /// Compares the bytes of two buffers for equality.
+  /// @param lhs The first buffer to compare.
+  /// @param rhs The other buffer to compare.
+  /// @return true if both buffers contain the same bytes, otherwise false.
+  friend bool operator==(const BinaryBuffer& lhs, const BinaryBuffer& rhs)
+  {
+    return lhs.size_ == rhs.size_ && (lhs.data_ == rhs.data_ || std::equal(lhs.begin(), lhs.end(), rhs.begin()));
+  }
+
+  /// Compares the bytes of two buffers for inequality.
+  /// @param lhs The first buffer to compare.
+  /// @param rhs The other buffer to compare.
+  /// @return true if the buffers do not contain the same bytes, otherwise false.
+  friend bool operator!=(const BinaryBuffer& lhs, const BinaryBuffer& rhs)
+  {
+    return !(lhs == rhs);
+  }
+
+private:
+  std::shared_ptr<const void> owner_;
+  const unsigned char* data_{nullptr};
+  std::size_t size_{0};
+};
+}
+}
@@ -0,0 +1,354 @@
+// @copyright_start
+// Copyright (c) 2018-2019 Cisco and/or its affiliates. All rights reserved.
+// @copyright_end
+
+/// @file efm_interned_path.h
+
+#pragma once
+
+#include <efm_node_path.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+
+namespace cisco
+{
+namespace efm_sdk
+{
+
+/// @brief The process wide table of interned paths, see cisco::efm_sdk::InternedPath.
+
+/// Every distinct path is stored once and gets a stable 32 bit identifier. Identifiers are never reused, interned
+/// paths live until the end of the process. Interning and looking up a path by its text take a lock, resolving an
+/// identifier to its path does not. The entries are allocated in chunks of 256 paths as the table grows.
+class PathTable
+{
+public:
+  /// The identifier of the empty path.
+  static const uint32_t empty_id = 0;
+
+  /// This class is not copyable
+  PathTable(const PathTable&) = delete;
+  /// This class is not assignable
+  /// @return A reference to the PathTable object
+  PathTable& operator=(const PathTable&) = delete;
+
+  /// Returns the process wide table.
+  /// @return The table of interned paths.
+  static PathTable& instance()
+  {
+    static PathTable table;
+    return table;
+  }
+
+  /// Interns a path.
+  /// @throw std::length_error If the table is full.
+  /// @param path The path to intern.
+  /// @return The identifier of the path. Equal paths always get the same identifier.
+  uint32_t intern(const NodePath& path)
+  {
+    const std::size_t hash = std::hash<std::string>{}(path.to_string());
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = find_locked(path, hash);
+    if (it != ids_.end()) {
+      return *it;
+    }
+
+    const uint32_t id = size_.load(std::memory_order_relaxed);
+    if (id == static_cast<uint32_t>(directories * directory_size * chunk_size)) {
+      throw std::length_error("too many interned paths");
+    }
+    std::atomic<Entry*>* directory = directories_[id / (directory_size * chunk_size)].load(std::memory_order_relaxed);
+    if (directory == nullptr) {
+      directory = new std::atomic<Entry*>[directory_size];
+      for (std::size_t i = 0; i < directory_size; ++i) {
+        directory[i].store(nullptr, std::memory_order_relaxed);
+      }
+      directories_[id / (directory_size * chunk_size)].store(directory, std::memory_order_release);
+    }
+    Entry* chunk = directory[id / chunk_size % directory_size].load(std::memory_order_relaxed);
+    if (chunk == nullptr) {
+      chunk = new Entry[chunk_size];
+      directory[id / chunk_size % directory_size].store(chunk, std::memory_order_release);
+    }
+    chunk[id % chunk_size].path_ = path;
+    chunk[id % chunk_size].hash_ = hash;
+    ids_.insert(id);
+    size_.store(id + 1, std::memory_order_release);
+    return id;
+  }
+
+  /// Looks up the identifier of a path without interning it.
+  /// @param path The path to look up.
+  /// @param id Will be set to the identifier of the path if it is interned.
+  /// @return true if the path is interned, otherwise false.
+  bool find(const NodePath& path, uint32_t& id) const
+  {
+    const std::size_t hash = std::hash<std::string>{}(path.to_string());
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = find_locked(path, hash);
+    if (it == ids_.end()) {
+      return false;
+    }
+    id = *it;
+    return true;
+  }
+
+  /// Returns the path of an identifier returned by PathTable::intern.
+  /// @param id The identifier of the path.
+  /// @return The interned path.
+  const NodePath& path(uint32_t id) const
+  {
+    return entry(id).path_;
+  }
+
+  /// Returns the number of interned paths, including the empty path.
+  /// @return The number of interned paths.
+  std::size_t size() const
+  {
+    return size_.load(std::memory_order_acquire);
+  }
+
+  /// Releases all interned paths.
+  ~PathTable()
+  {
+    for (std::size_t i = 0; i < directories; ++i) {
+      std::atomic<Entry*>* directory = directories_[i].load(std::memory_order_relaxed);
+      if (directory != nullptr) {
+        for (std::size_t j = 0; j < directory_size; ++j) {
+          delete[] directory[j].load(std::memory_order_relaxed);
+        }
+        delete[] directory;
+      }
+    }
+  }
+
+private:
+  // Identifiers are resolved through a directory of chunk pointers, both are allocated on first use.
+  static const std::size_t chunk_size = 256;
+  static const std::size_t directory_size = 1024;
+  static const std::size_t directories = 1024;
+  static const uint32_t probe_id = UINT32_MAX;
+
+  struct Entry
+  {
+    NodePath path_;
+    std::size_t hash_{0};
+  };
+
+  // The set stores identifiers only, the text is stored once in the entries. Lookups by text go through the
+  // probe identifier, which refers to the path being looked up.
+  struct IdHash
+  {
+    const PathTable* table_;
+
+    std::size_t operator()(uint32_t id) const
+    {
+      return id == probe_id ? table_->probe_hash_ : table_->entry(id).hash_;
+    }
+  };
+
+  struct IdEqual
+  {
+    const PathTable* table_;
+
+    bool operator()(uint32_t lhs, uint32_t rhs) const
+    {
+      return lhs == rhs || table_->text(lhs) == table_->text(rhs);
+    }
+  };
+
+  using IdSet = std::unordered_set<uint32_t, IdHash, IdEqual>;
+
+  PathTable()
+    : ids_(0, IdHash{this}, IdEqual{this})
+  {
+    for (std::size_t i = 0; i < directories; ++i) {
+      directories_[i].store(nullptr, std::memory_order_relaxed);
+    }
+    intern(NodePath());
+  }
+
+  const Entry& entry(uint32_t id) const
+  {
+    const std::atomic<Entry*>* directory =
+      directories_[id / (directory_size * chunk_size)].load(std::memory_order_acquire);
+    return directory[id / chunk_size % directory_size].load(std::memory_order_acquire)[id % chunk_size];
+  }
+
+  const std::string& text(uint32_t id) const
+  {
+    return id == probe_id ? *probe_ : entry(id).path_.to_string();
+  }
+
+  IdSet::const_iterator find_locked(const NodePath& path, std::size_t hash) const
+  {
+    probe_ = &path.to_string();
+    probe_hash_ = hash;
+    return ids_.find(static_cast<uint32_t>(probe_id));
+  }
+
+  mutable std::mutex mutex_;
+  std::atomic<std::atomic<Entry*>*> directories_[directories];
+  std::atomic<uint32_t> size_{0};
+  IdSet ids_;
+  mutable const std::string* probe_{nullptr};
+  mutable std::size_t probe_hash_{0};
+};
+
+
+/// @brief A compact handle of an interned cisco::efm_sdk::NodePath.
+
+/// An InternedPath is a 32 bit identifier of a path stored once in the process wide PathTable. Copying, comparing
+/// and hashing interned paths are integer operations, which makes them cheap keys for maps of many nodes:
+///
+/// @code
+///     cisco::efm_sdk::InternedPath temperature("/sensors/room-1/temperature");
+///     std::unordered_map<cisco::efm_sdk::InternedPath, double, cisco::efm_sdk::InternedPath::Hash> last_values;
+///     last_values[temperature] = 21.5;
+///     responder->set_value(temperature, cisco::efm_sdk::Variant(21.5), [](const std::error_code&) {});
+/// @endcode
+///
+/// An InternedPath converts to `const NodePath&` without copying the path, so it can be passed to all APIs taking a
+/// NodePath. Interned paths are ordered by their identifiers, i.e. in the order they were interned. Use
+/// InternedPath::path for a lexicographic ordering.
+class InternedPath
+{
+public:
+  /// Constructs the interned empty path.
+  InternedPath() = default;
+
+  /// Interns a path.
+  /// @param path The path to intern.
+  explicit InternedPath(const NodePath& path)
+    : id_(PathTable::instance().intern(path))
+  {
+  }
+
+  /// Looks up an interned path without interning it, e.g. for paths received from a peer.
+  /// @param path The path to look up.
+  /// @return The interned path or the empty interned path if the path is not interned.
+  static InternedPath find(const NodePath& path)
+  {
+    InternedPath interned;
+    PathTable::instance().find(path, interned.id_);
+    return interned;
+  }
+
+  /// Returns the identifier of the path.
+  /// @return The identifier, unique for every distinct path within the process.
+  uint32_t id() const noexcept
+  {
+    return id_;
+  }
+
+  /// Checks if this is the empty path.
+  /// @return true if the path is empty, false otherwise.
+  bool empty() const noexcept
+  {
+    return id_ == PathTable::empty_id;
+  }
+
+  /// Returns the path.
+  /// @return The interned path.
+  const NodePath& path() const
+  {
+    return PathTable::instance().path(id_);
+  }
+
+  /// Returns the path.
+  /// @return The interned path.
+  operator const NodePath&() const
+  {
+    return path();
+  }
+
+  /// Compares two interned paths for equality.
+  /// @param lhs The first path to compare.
+  /// @param rhs The other path to compare.
+  /// @return true if the paths are equal, false otherwise
+  friend bool operator==(InternedPath lhs, InternedPath rhs) noexcept
+  {
+    return lhs.id_ == rhs.id_;
+  }
+
+  /// Compares two interned paths for inequality.
+  /// @param lhs The first path to compare.
+  /// @param rhs The other path to compare.
+  /// @return true if the paths are not equal, false otherwise
+  friend bool operator!=(InternedPath lhs, InternedPath rhs) noexcept
+  {
+    return lhs.id_ != rhs.id_;
+  }
+
+  /// Compares the identifiers of two interned paths.
+  /// @param lhs The first path to compare.
+  /// @param rhs The other path to compare.
+  /// @return true if the left path was interned before the right one, otherwise false.
+  friend bool operator<(InternedPath lhs, InternedPath rhs) noexcept
+  {
+    return lhs.id_ < rhs.id_;
+  }
+
+  /// Compares the identifiers of two interned paths.
+  /// @param lhs The first path to compare.
+  /// @param rhs The other path to compare.
+  /// @return true if the left path was interned after the right one, otherwise false.
+  friend bool operator>(InternedPath lhs, InternedPath rhs) noexcept
+  {
+    return lhs.id_ > rhs.id_;
+  }
+
+  /// Computes a hash value for InternedPath.
+  struct Hash
+  {
+    /// Computes a hash value for InternedPath.
+    /// @param path The path to compute the hash for.
+    /// @return The computed hash.
+    std::size_t operator()(InternedPath path) const noexcept
+    {
+      return path.id_;
+    }
+  };
+
+private:
+  uint32_t id_{PathTable::empty_id};
+};
+
+/// stream insertion operator for InternedPath
+///
+/// @tparam CharT Character type for the ostream
+/// @tparam Traits Traits to be used by the ostream
+/// @param os the stream to insert the object into
+/// @param path the InternedPath object to insert
+/// @return the std::basic_ostream object
+template <class CharT, class Traits>
+std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, InternedPath path)
+{
+  return os << path.path();
+}
+}
+}
+
+namespace std
+{
+/// Computes a hash value for InternedPath.
+template <>
+struct hash<cisco::efm_sdk::InternedPath>
+{
+  /// Computes a hash value for InternedPath.
+  /// @param path The path to compute the hash for.
+  /// @return The computed hash.
+  std::size_t operator()(cisco::efm_sdk::InternedPath path) const noexcept
+  {
+    return cisco::efm_sdk::InternedPath::Hash{}(path);
+  }
+};
+}
@@ -0,0 +1,445 @@
+// @copyright_start
+// Copyright (c) 2018-2019 Cisco and/or its affiliates. All rights reserved.
+// @copyright_end
+
+/// @file efm_msgpack.h
+
+#pragma once
+
+#include <efm_binary_buffer.h>
+#include <efm_error_code.h>
+#include <efm_exception.h>
+#include <efm_variant.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace cisco
+{
+namespace efm_sdk
+{
+namespace msgpack
+{
+/// @private
+namespace detail
+{
+inline void put(std::vector<unsigned char>& out, unsigned char type)
+{
+  out.push_back(type);
+}
+
+template <typename T>
+void put(std::vector<unsigned char>& out, unsigned char type, T value)
+{
+  unsigned char bytes[1 + sizeof(T)];
+  bytes[0] = type;
+  for (std::size_t i = 0; i < sizeof(T); ++i) {
+    bytes[sizeof(T) - i] = static_cast<unsigned char>(value >> (8 * i));
+  }
+  out.insert(out.end(), bytes, bytes + sizeof(bytes));
+}
+
+inline void put_double(std::vector<unsigned char>& out, double value)
+{
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  put(out, 0xCB, bits);
+}
+
+inline void put_float(std::vector<unsigned char>& out, float value)
+{
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  put(out, 0xCA, bits);
+}
+
+inline void put_uint(std::vector<unsigned char>& out, uint64_t value)
+{
+  if (value < 0x80) {
+    put(out, static_cast<unsigned char>(value));
+  } else if (value <= 0xFF) {
+    put(out, 0xCC, static_cast<uint8_t>(value));
+  } else if (value <= 0xFFFF) {
+    put(out, 0xCD, static_cast<uint16_t>(value));
+  } else if (value <= 0xFFFFFFFF) {
+    put(out, 0xCE, static_cast<uint32_t>(value));
+  } else {
+    put(out, 0xCF, value);
+  }
+}
+
+inline void put_int(std::vector<unsigned char>& out, int64_t value)
+{
+  if (value >= 0) {
+    put_uint(out, static_cast<uint64_t>(value));
+  } else if (value >= -32) {
+    put(out, static_cast<unsigned char>(value));
+  } else if (value >= INT8_MIN) {
+    put(out, 0xD0, static_cast<uint8_t>(value));
+  } else if (value >= INT16_MIN) {
+    put(out, 0xD1, static_cast<uint16_t>(value));
+  } else if (value >= INT32_MIN) {
+    put(out, 0xD2, static_cast<uint32_t>(value));
+  } else {
+    put(out, 0xD3, static_cast<uint64_t>(value));
+  }
+}
+
+inline void put_header(std::vector<unsigned char>& out, std::size_t size, unsigned char fix, unsigned char type16)
+{
+  if (size < 16) {
+    put(out, static_cast<unsigned char>(fix | size));
+  } else if (size <= 0xFFFF) {
+    put(out, type16, static_cast<uint16_t>(size));
+  } else {
+    put(out, static_cast<unsigned char>(type16 + 1), static_cast<uint32_t>(size));
+  }
+}
+
+inline void put_bytes(std::vector<unsigned char>& out, const void* data, std::size_t size, bool binary)
+{
+  if (!binary && size < 32) {
+    put(out, static_cast<unsigned char>(0xA0 | size));
+  } else if (size <= 0xFF) {
+    put(out, binary ? 0xC4 : 0xD9, static_cast<uint8_t>(size));
+  } else if (size <= 0xFFFF) {
+    put(out, binary ? 0xC5 : 0xDA, static_cast<uint16_t>(size));
+  } else {
+    put(out, binary ? 0xC6 : 0xDB, static_cast<uint32_t>(size));
+  }
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  out.insert(out.end(), bytes, bytes + size);
+}
+
+inline void encode_value(const Variant& value, std::vector<unsigned char>& out)
+{
+  switch (value.type()) {
+    case Variant::Null:
+      put(out, 0xC0);
+      break;
+    case Variant::Bool:
+      put(out, value.as_bool() ? 0xC3 : 0xC2);
+      break;
+    case Variant::Int:
+      put_int(out, value.as_int());
+      break;
+    case Variant::UInt:
+      put_uint(out, value.as_uint());
+      break;
+    case Variant::Double:
+      put_double(out, value.as_double());
+      break;
+    case Variant::String:
+      put_bytes(out, value.as_string().data(), value.as_string().size(), false);
+      break;
+    case Variant::Binary:
+      put_bytes(out, value.as_binary().data(), value.as_binary().size(), true);
+      break;
+    case Variant::Map:
+      put_header(out, value.as_map().size(), 0x80, 0xDE);
+      for (const auto& element : value.as_map()) {
+        put_bytes(out, element.first.data(), element.first.size(), false);
+        encode_value(element.second, out);
+      }
+      break;
+    case Variant::Array:
+      put_header(out, value.as_array().size(), 0x90, 0xDC);
+      for (const auto& element : value.as_array()) {
+        encode_value(element, out);
+      }
+      break;
+    case Variant::DoubleArray:
+      put_header(out, value.as_double_array().size(), 0x90, 0xDC);
+      for (double element : value.as_double_array()) {
+        put_double(out, element);
+      }
+      break;
+    case Variant::FloatArray:
+      put_header(out, value.as_float_array().size(), 0x90, 0xDC);
+      for (float element : value.as_float_array()) {
+        put_float(out, element);
+      }
+      break;
+    case Variant::IntArray:
+      put_header(out, value.as_int_array().size(), 0x90, 0xDC);
+      for (int64_t element : value.as_int_array()) {
+        put_int(out, element);
+      }
+      break;
+  }
+}
+
+/// @brief Reads MessagePack encoded values.
+class Decoder
+{
+public:
+  Decoder(const unsigned char* data, std::size_t size, std::shared_ptr<const void> owner)
+    : begin_(data)
+    , p_(data)
+    , end_(data + size)
+    , owner_(std::move(owner))
+  {
+  }
+
+  Variant value(int depth)
+  {
+    if (depth > 512) {
+      fail("nesting too deep");
+    }
+
+    const unsigned char type = byte();
+    if (type < 0x80) {
+      return Variant(static_cast<int64_t>(type));
+    }
+    if (type >= 0xE0) {
+      return Variant(static_cast<int64_t>(static_cast<int8_t>(type)));
+    }
+    if ((type & 0xF0) == 0x80) {
+      return map(type & 0x0F, depth);
+    }
+    if ((type & 0xF0) == 0x90) {
+      return array(type & 0x0F, depth);
+    }
+    if ((type & 0xE0) == 0xA0) {
+      return string(type & 0x1F);
+    }
+
+    switch (type) {
+      case 0xC0:
+        return Variant();
+      case 0xC2:
+        return Variant(false);
+      case 0xC3:
+        return Variant(true);
+      case 0xC4:
+        return binary(read<uint8_t>());
+      case 0xC5:
+        return binary(read<uint16_t>());
+      case 0xC6:
+        return binary(read<uint32_t>());
+      case 0xCA: {
+        const uint32_t bits = read<uint32_t>();
+        float f;
+        std::memcpy(&f, &bits, sizeof(f));
+        return number(static_cast<double>(f));
+      }
+      case 0xCB: {
+        const uint64_t bits = read<uint64_t>();
+        double d;
+        std::memcpy(&d, &bits, sizeof(d));
+        return number(d);
+      }
+      case 0xCC:
+        return Variant(static_cast<int64_t>(read<uint8_t>()));
+      case 0xCD:
+        return Variant(static_cast<int64_t>(read<uint16_t>()));
+      case 0xCE:
+        return Variant(static_cast<int64_t>(read<uint32_t>()));
+      case 0xCF: {
+        const uint64_t n = read<uint64_t>();
+        return n <= static_cast<uint64_t>(INT64_MAX) ? Variant(static_cast<int64_t>(n)) : Variant(n);
+      }
+      case 0xD0:
+        return Variant(static_cast<int64_t>(static_cast<int8_t>(read<uint8_t>())));
+      case 0xD1:
+        return Variant(static_cast<int64_t>(static_cast<int16_t>(read<uint16_t>())));
+      case 0xD2:
+        return Variant(static_cast<int64_t>(static_cast<int32_t>(read<uint32_t>())));
+      case 0xD3:
+        return Variant(static_cast<int64_t>(read<uint64_t>()));
+      case 0xD9:
+        return string(read<uint8_t>());
+      case 0xDA:
+        return string(read<uint16_t>());
+      case 0xDB:
+        return string(read<uint32_t>());
+      case 0xDC:
+        return array(read<uint16_t>(), depth);
+      case 0xDD:
+        return array(read<uint32_t>(), depth);
+      case 0xDE:
+        return map(read<uint16_t>(), depth);
+      case 0xDF:
+        return map(read<uint32_t>(), depth);
+      default:
+        fail("unsupported type");
+    }
+  }
+
+  bool at_end() const
+  {
+    return p_ == end_;
+  }
+
+  [[noreturn]] void fail(const char* what) const
+  {
+    throw exception(
+      error_code::invalid_value,
+      std::string("invalid MessagePack at offset ") + std::to_string(p_ - begin_) + ": " + what);
+  }
+
+private:
+  unsigned char byte()
+  {
+    need(1);
+    return *p_++;
+  }
+
+  void need(std::size_t size) const
+  {
+    if (static_cast<std::size_t>(end_ - p_) < size) {
+      fail("unexpected end of data");
+    }
+  }
+
+  template <typename T>
+  T read()
+  {
+    need(sizeof(T));
+    T value = 0;
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+      value = static_cast<T>((static_cast<uint64_t>(value) << 8) | *p_++);
+    }
+    return value;
+  }
+
+  Variant number(double value)
+  {
+    std::error_code ec;
+    Variant v = Variant::make_double(value, ec);
+    if (ec) {
+      fail("number out of range");
+    }
+    return v;
+  }
+
+  Variant string(std::size_t size)
+  {
+    need(size);
+    const char* chars = reinterpret_cast<const char*>(p_);
+    p_ += size;
+    return Variant(std::string(chars, size));
+  }
+
+  Variant binary(std::size_t size)
+  {
+    need(size);
+    const unsigned char* bytes = p_;
+    p_ += size;
+    if (owner_) {
+      return Variant(BinaryBuffer(bytes, size, owner_));
+    }
+    return Variant(BinaryBuffer(bytes, size));
+  }
+
+  std::string key()
+  {
+    const unsigned char type = byte();
+    std::size_t size;
+    if ((type & 0xE0) == 0xA0) {
+      size = type & 0x1F;
+    } else if (type == 0xD9) {
+      size = read<uint8_t>();
+    } else if (type == 0xDA) {
+      size = read<uint16_t>();
+    } else if (type == 0xDB) {
+      size = read<uint32_t>();
+    } else {
+      fail("map key is not a string");
+    }
+    need(size);
+    const char* chars = reinterpret_cast<const char*>(p_);
+    p_ += size;
+    return std::string(chars, size);
+  }
+
+  Variant array(std::size_t size, int depth)
+  {
+    // every element takes at least one byte, which bounds the reservation for malformed sizes
+    need(size);
+    Variant::ArrayType array;
+    array.reserve(size);
+    for (std::size_t i = 0; i < size; ++i) {
+      array.push_back(value(depth + 1));
+    }
+    return Variant(std::move(array));
+  }
+
+  Variant map(std::size_t size, int depth)
+  {
+    need(size * 2);
+    std::vector<std::pair<std::string, Variant>> members;
+    members.reserve(size);
+    for (std::size_t i = 0; i < size; ++i) {
+      std::string k = key();
+      Variant v = value(depth + 1);
+      members.emplace_back(std::move(k), std::move(v));
+    }
+    return Variant(efm_sdk::detail::make_map(std::move(members)));
+  }
+
+  const unsigned char* begin_;
+  const unsigned char* p_;
+  const unsigned char* end_;
+  std::shared_ptr<const void> owner_;
+};
+}
+
+/// Appends the MessagePack encoding of a variant. Binaries are encoded as `bin`, typed arrays as arrays of `float 64`,
+/// `float 32` or integers respectively. The SDK library does not use this codec, links exchange JSON with the broker.
+/// @param value The variant to encode.
+/// @param out The buffer to append to.
+inline void encode(const Variant& value, std::vector<unsigned char>& out)
+{
+  detail::encode_value(value, out);
+}
+
+/// Returns the MessagePack encoding of a variant, see cisco::efm_sdk::msgpack::encode(const Variant&,
+/// std::vector<unsigned char>&).
+/// @param value The variant to encode.
+/// @return The encoded variant.
+inline std::vector<unsigned char> encode(const Variant& value)
+{
+  std::vector<unsigned char> out;
+  detail::encode_value(value, out);
+  return out;
+}
+
+/// Decodes a MessagePack encoded variant. Integers are decoded as Variant::Int (Variant::UInt if they exceed the range
+/// of int64_t), floats as Variant::Double and `bin` as Variant::Binary. The bytes of binaries are copied.
+/// @throw cisco::efm_sdk::exception If the data is not a valid MessagePack encoding or uses extension types.
+/// @param data The encoded data.
+/// @param size The size of the encoded data.
+/// @return The decoded variant.
+inline Variant decode(const unsigned char* data, std::size_t size)
+{
+  detail::Decoder decoder(data, size, nullptr);
+  Variant value = decoder.value(0);
+  if (!decoder.at_end()) {
+    decoder.fail("trailing bytes");
+  }
+  return value;
+}
+
+/// Decodes a MessagePack encoded variant, see cisco::efm_sdk::msgpack::decode(const unsigned char*, std::size_t). The
+/// bytes of binaries are not copied, they reference the given data, which is kept alive by the binaries.
+/// @throw cisco::efm_sdk::exception If the data is not a valid MessagePack encoding or uses extension types.
+/// @param data The encoded data.
+/// @return The decoded variant.
+inline Variant decode(const std::shared_ptr<const std::vector<unsigned char>>& data)
+{
+  detail::Decoder decoder(data->data(), data->size(), data);
+  Variant value = decoder.value(0);
+  if (!decoder.at_end()) {
+    decoder.fail("trailing bytes");
+  }
+  return value;
+}
+}
+}
+}
@@ -6,7 +6,12 @@
 
 #pragma once
 
+#include <efm_string_view.h>
+
+#include <cstddef>
 #include <functional>
+#include <iterator>
+#include <stdexcept>
 #include <string>
 
 
@@ -15,6 +20,98 @@ namespace cisco
 namespace efm_sdk
 {
 
+/// @private
+namespace detail
+{
+constexpr bool is_invalid_path_char(char c) noexcept
+{
+  return static_cast<unsigned char>(c) < 0x20 || c == '\\' || c == '?' || c == '*' || c == ':' || c == '|' ||
+         c == '<' || c == '>' || c == '"';
+}
+
+/// Checks that the characters [first, last) of a path are valid in node names and form no empty segments. The range
+/// is split in halves, so the recursion depth of the constant evaluation only grows with the logarithm of the length.
+constexpr bool is_valid_path_range(const char* data, std::size_t first, std::size_t last) noexcept
+{
+  return last - first == 1 ? !is_invalid_path_char(data[first]) &&
+                               (first == 0 || data[first] != '/' || data[first - 1] != '/')
+                           : is_valid_path_range(data, first, first + (last - first) / 2) &&
+                               is_valid_path_range(data, first + (last - first) / 2, last);
+}
+
+/// Checks that a path starts with `/`, has no empty segments, no trailing `/` (except for the root path) and no
+/// characters invalid in node names.
+constexpr bool is_valid_path(const char* data, std::size_t size) noexcept
+{
+  return size > 0 && data[0] == '/' && (size == 1 || data[size - 1] != '/') && is_valid_path_range(data, 0, size);
+}
+}
+
+/// @brief A node path known at compile time.
+
+/// The path is validated at compile time. An invalid path fails to compile if the literal is a constant expression:
+///
+/// @code
+///     constexpr cisco::efm_sdk::PathLiteral seq_path("/seq");
+///     constexpr cisco::efm_sdk::PathLiteral invalid("seq"); // error: not a constant expression
+/// @endcode
+///
+/// Use EFM_NODE_PATH to get a `const NodePath&` that is created once, so hot call sites do not build a path string for
+/// every call.
+class PathLiteral
+{
+public:
+  /// Constructs a path literal from a string literal.
+  /// @throw std::invalid_argument If the path is invalid (a compile error in constant expressions).
+  /// @param path The path.
+  template <std::size_t N>
+  constexpr PathLiteral(const char (&path)[N])
+    : PathLiteral(path, N - 1)
+  {
+  }
+
+  /// Constructs a path literal from a character sequence.
+  /// @throw std::invalid_argument If the path is invalid (a compile error in constant expressions).
+  /// @param path The characters of the path.
+  /// @param size The number of characters.
+  constexpr PathLiteral(const char* path, std::size_t size)
+    : data_(
+        detail::is_valid_path(path, size) ? path : (throw std::invalid_argument("invalid node path literal"), path))
+    , size_(size)
+  {
+  }
+
+  /// Returns the characters of the path, which are null terminated for string literals.
+  /// @return A pointer to the first character.
+  constexpr const char* data() const noexcept
+  {
+    return data_;
+  }
+
+  /// Returns the number of characters of the path.
+  /// @return The number of characters.
+  constexpr std::size_t size() const noexcept
+  {
+    return size_;
+  }
+
+private:
+  const char* data_;
+  std::size_t size_;
+};
+
+inline namespace literals
+{
+/// Creates a PathLiteral, e.g. `constexpr auto seq_path = "/seq"_path;`.
+/// @param path The characters of the path.
+/// @param size The number of characters.
+/// @return The path literal.
+constexpr PathLiteral operator"" _path(const char* path, std::size_t size)
+{
+  return PathLiteral(path, size);
+}
+}
+
 /// @brief The NodePath describes the path in the node tree to a given node.
 
 /// A path is composed of path components. Each component is a sub-path, which has to be separated by '`/`' characters.
@@ -24,6 +121,8 @@ class NodePath
 {
 public:
   class Iterator;
+  class SegmentIterator;
+  class Segments;
 
   /// Constructs an empty NodePath.
   NodePath() = default;
@@ -49,6 +148,13 @@ public:
   {
   }
 
+  /// Constructs a NodePath from a path literal.
+  /// @param path The path literal.
+  NodePath(const PathLiteral& path)
+    : path_(path.data(), path.size())
+  {
+  }
+
   /// Move constructs a node path from another NodePath.
   /// @param other The NodePath to move into this path.
   NodePath(NodePath&& other)
@@ -202,6 +308,74 @@ public:
   /// @return The name as string of the path
   std::string get_name() const;
 
+  /// Returns a view of the whole path.
+  /// @return The view of the path. Valid as long as the path is not modified or destroyed.
+  StringView view() const noexcept
+  {
+    return StringView(path_);
+  }
+
+  /// Returns a view of the name (i.e. the last part) of the path like NodePath::get_name, without allocating. Will be
+  /// empty for the root node.
+  /// @return The view of the name. Valid as long as the path is not modified or destroyed.
+  StringView name_view() const noexcept
+  {
+    const StringView path = trimmed();
+    const auto pos = path.rfind('/');
+    return pos == StringView::npos ? path : path.substr(pos + 1);
+  }
+
+  /// Returns a view of the parent path like NodePath::get_parent_path, without allocating. The parent of a top level
+  /// node is `/`, the root node has an empty parent.
+  /// @return The view of the parent path. Valid as long as the path is not modified or destroyed.
+  StringView parent_view() const noexcept
+  {
+    const StringView path = trimmed();
+    auto pos = path.rfind('/');
+    if (pos == StringView::npos || path.size() <= 1) {
+      return StringView();
+    }
+    while (pos > 0 && path[pos - 1] == '/') {
+      --pos;
+    }
+    return pos == 0 ? path.substr(0, 1) : path.substr(0, pos);
+  }
+
+  /// Returns a view of the base of the path like NodePath::get_base, without allocating.
+  /// @param rest Will be set to the rest of the path if the base is removed. Will be empty if there is no rest.
+  /// @return The base of the path without leading `/`, if there is one. Otherwise an empty view.
+  StringView base_view(StringView& rest) const noexcept
+  {
+    StringView path = view();
+    std::size_t start = 0;
+    while (start < path.size() && path[start] == '/') {
+      ++start;
+    }
+    const auto end = path.find('/', start);
+    if (end == StringView::npos) {
+      rest = StringView();
+      return path.substr(start);
+    }
+    rest = path.substr(end);
+    if (rest.size() == 1) {
+      rest = StringView();
+    }
+    return path.substr(start, end - start);
+  }
+
+  /// Returns the segments of the path, i.e. the names of the nodes from the top level node down to this node. Unlike
+  /// NodePath::begin and NodePath::end no path is built for the segments.
+  ///
+  /// @code
+  ///     cisco::efm_sdk::NodePath p("/downstream/my-link/first_node");
+  ///     for (cisco::efm_sdk::StringView segment : p.segments()) {
+  ///       // "downstream", "my-link", "first_node"
+  ///     }
+  /// @endcode
+  ///
+  /// @return The range of segments. Valid as long as the path is not modified or destroyed.
+  Segments segments() const noexcept;
+
   template <class CharT, class Traits>
   friend std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, const NodePath& path);
 
@@ -233,6 +407,16 @@ private:
   /// @return The hash of the node path.
   std::size_t get_hash() const;
 
+  /// Returns the path without trailing `/`, except for the root path.
+  StringView trimmed() const noexcept
+  {
+    std::size_t size = path_.size();
+    while (size > 1 && path_[size - 1] == '/') {
+      --size;
+    }
+    return StringView(path_.data(), size);
+  }
+
   std::string path_;
   mutable std::size_t hash_{0};
 };
@@ -287,6 +471,134 @@ private:
   std::string::size_type pos_{std::string::npos};
 };
 
+/// @brief Iterator over the segments of a NodePath as views, see NodePath::segments.
+class NodePath::SegmentIterator
+{
+public:
+  /// @private
+  using iterator_category = std::forward_iterator_tag;
+  /// @private
+  using value_type = StringView;
+  /// @private
+  using difference_type = std::ptrdiff_t;
+  /// alias for const pointer to StringView
+  using pointer = const StringView*;
+  /// alias for StringView, segments are returned by value
+  using reference = StringView;
+
+  /// Constructs an end iterator.
+  SegmentIterator() noexcept = default;
+
+  /// dereferences the iterator
+  /// @return The current segment
+  StringView operator*() const noexcept
+  {
+    return segment_;
+  }
+
+  /// dereferences the iterator
+  /// @return A pointer to the current segment
+  pointer operator->() const noexcept
+  {
+    return &segment_;
+  }
+
+  /// increments the iterator
+  /// @return A reference to the incremented iterator
+  SegmentIterator& operator++() noexcept
+  {
+    const char* p = segment_.end();
+    while (p != end_ && *p == '/') {
+      ++p;
+    }
+    const char* next = p;
+    while (next != end_ && *next != '/') {
+      ++next;
+    }
+    segment_ = p == end_ ? StringView() : StringView(p, static_cast<std::size_t>(next - p));
+    return *this;
+  }
+
+  /// increments the iterator
+  /// @return The iterator before the increment
+  SegmentIterator operator++(int) noexcept
+  {
+    SegmentIterator previous = *this;
+    ++*this;
+    return previous;
+  }
+
+  /// Compare this iterator to another one for equality.
+  /// @param other The iterator to compare to this one.
+  /// @return true if both iterators are identical, false otherwise.
+  bool operator==(const SegmentIterator& other) const noexcept
+  {
+    return segment_.data() == other.segment_.data();
+  }
+
+  /// Compare this iterator to another one for inequality.
+  /// @param other The iterator to compare to this one.
+  /// @return true if both iterators are not identical, false otherwise.
+  bool operator!=(const SegmentIterator& other) const noexcept
+  {
+    return !(*this == other);
+  }
+
+private:
+  friend class NodePath::Segments;
+
+  SegmentIterator(StringView path) noexcept
+    : segment_(path.data(), 0)
+    , end_(path.end())
+  {
+    ++*this;
+  }
+
+  StringView segment_;
+  const char* end_{nullptr};
+};
+
+/// @brief The range of segments of a NodePath, see NodePath::segments.
+class NodePath::Segments
+{
+public:
+  /// Returns the iterator to the first segment.
+  /// @return The start iterator.
+  SegmentIterator begin() const noexcept
+  {
+    return SegmentIterator(path_);
+  }
+
+  /// Returns the end iterator.
+  /// @return The end iterator.
+  SegmentIterator end() const noexcept
+  {
+    return SegmentIterator();
+  }
+
+  /// Checks if there are no segments, i.e. for the root and the empty path.
+  /// @return true if there are no segments, otherwise false.
+  bool empty() const noexcept
+  {
+    return begin() == end();
+  }
+
+private:
+  friend class NodePath;
+
+  explicit Segments(StringView path) noexcept
+    : path_(path)
+  {
+  }
+
+  StringView path_;
+};
+
+inline NodePath::Segments NodePath::segments() const noexcept
+{
+  return Segments(view());
+}
+
 /// stream insertion operator for NodePath
 ///
 /// @tparam CharT Character type for the ostream
@@ -303,6 +615,19 @@ std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>&
 }
 }
 
+/// Returns a `const cisco::efm_sdk::NodePath&` for a string literal. The path is validated at compile time, the
+/// NodePath is created once, on first use.
+///
+/// @code
+///     responder->set_value(EFM_NODE_PATH("/seq"), Variant(seq), [](const std::error_code&) {});
+/// @endcode
+#define EFM_NODE_PATH(literal)                                                                                        \
+  ([]() -> const ::cisco::efm_sdk::NodePath& {                                                                        \
+    static constexpr ::cisco::efm_sdk::PathLiteral efm_path_literal(literal);                                         \
+    static const ::cisco::efm_sdk::NodePath efm_node_path(efm_path_literal);                                          \
+    return efm_node_path;                                                                                             \
+  }())
+
 namespace std
 {
 /// Computes a hash value for NodePath.
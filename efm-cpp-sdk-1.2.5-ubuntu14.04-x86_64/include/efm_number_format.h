@@ -0,0 +1,344 @@
+// @copyright_start
+// Copyright (c) 2018-2019 Cisco and/or its affiliates. All rights reserved.
+// @copyright_end
+
+/// @file efm_number_format.h
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#endif
+
+namespace cisco
+{
+namespace efm_sdk
+{
+namespace number
+{
+/// The maximum number of characters written by one of the format functions.
+static const std::size_t max_formatted_length = 32;
+
+/// Formats an unsigned integer as decimal number.
+/// @param value The value to format.
+/// @param out The buffer to write to. Has to provide at least number::max_formatted_length characters.
+/// @return A pointer past the last written character.
+inline char* format_uint(uint64_t value, char* out)
+{
+  static const char digit_pairs[] = "00010203040506070809"
+                                    "10111213141516171819"
+                                    "20212223242526272829"
+                                    "30313233343536373839"
+                                    "40414243444546474849"
+                                    "50515253545556575859"
+                                    "60616263646566676869"
+                                    "70717273747576777879"
+                                    "80818283848586878889"
+                                    "90919293949596979899";
+
+  char buffer[20];
+  char* p = buffer + sizeof(buffer);
+  while (value >= 100) {
+    const unsigned int i = static_cast<unsigned int>(value % 100) * 2;
+    value /= 100;
+    *--p = digit_pairs[i + 1];
+    *--p = digit_pairs[i];
+  }
+  if (value >= 10) {
+    const unsigned int i = static_cast<unsigned int>(value) * 2;
+    *--p = digit_pairs[i + 1];
+    *--p = digit_pairs[i];
+  } else {
+    *--p = static_cast<char>('0' + value);
+  }
+
+  const std::size_t length = static_cast<std::size_t>(buffer + sizeof(buffer) - p);
+  std::memcpy(out, p, length);
+  return out + length;
+}
+
+/// Formats an integer as decimal number.
+/// @param value The value to format.
+/// @param out The buffer to write to. Has to provide at least number::max_formatted_length characters.
+/// @return A pointer past the last written character.
+inline char* format_int(int64_t value, char* out)
+{
+  if (value < 0) {
+    *out++ = '-';
+    return format_uint(0 - static_cast<uint64_t>(value), out);
+  }
+  return format_uint(static_cast<uint64_t>(value), out);
+}
+
+/// @private
+inline char* format_integral(double value, char* out)
+{
+  if (value == 0 && std::signbit(value)) {
+    *out++ = '-';
+  }
+  out = format_int(static_cast<int64_t>(value), out);
+  *out++ = '.';
+  *out++ = '0';
+  return out;
+}
+
+/// @private
+/// Appends `.0` to a formatted number without decimal point or exponent, so it is read back as double.
+inline char* append_fraction(const char* begin, char* end)
+{
+  for (const char* p = begin; p != end; ++p) {
+    if (*p == '.' || *p == 'e' || *p == 'n') {
+      return end;
+    }
+  }
+  *end++ = '.';
+  *end++ = '0';
+  return end;
+}
+
+/// @private
+/// Writes significant digits with a decimal exponent (the exponent of the first digit) like printf `%g` does.
+inline char* format_significant(bool negative, const char* digits, int count, int exponent, char* out)
+{
+  while (count > 1 && digits[count - 1] == '0') {
+    --count;
+  }
+  if (negative) {
+    *out++ = '-';
+  }
+
+  if (exponent < -4 || exponent >= 17) {
+    *out++ = digits[0];
+    if (count > 1) {
+      *out++ = '.';
+      std::memcpy(out, digits + 1, static_cast<std::size_t>(count - 1));
+      out += count - 1;
+    }
+    *out++ = 'e';
+    if (exponent < 0) {
+      *out++ = '-';
+      exponent = -exponent;
+    } else {
+      *out++ = '+';
+    }
+    if (exponent < 10) {
+      *out++ = '0';
+    }
+    return format_uint(static_cast<uint64_t>(exponent), out);
+  }
+
+  if (exponent < 0) {
+    *out++ = '0';
+    *out++ = '.';
+    for (int i = exponent + 1; i < 0; ++i) {
+      *out++ = '0';
+    }
+    std::memcpy(out, digits, static_cast<std::size_t>(count));
+    return out + count;
+  }
+
+  const int integral = exponent + 1;
+  if (count <= integral) {
+    std::memcpy(out, digits, static_cast<std::size_t>(count));
+    out += count;
+    for (int i = count; i < integral; ++i) {
+      *out++ = '0';
+    }
+    *out++ = '.';
+    *out++ = '0';
+    return out;
+  }
+  std::memcpy(out, digits, static_cast<std::size_t>(integral));
+  out += integral;
+  *out++ = '.';
+  std::memcpy(out, digits + integral, static_cast<std::size_t>(count - integral));
+  return out + count - integral;
+}
+
+/// Formats a finite double as decimal number. The output is the shortest number of significant digits that parses
+/// back to the identical value. Compiled as C++17 std::to_chars is used if available, otherwise (e.g. in the C++11
+/// builds of the examples) the shortest of 15, 16 or 17 significant digits is chosen, derived from a single `%.16e`
+/// conversion and checked with std::strtod. Every output without an exponent gets a decimal point, integral values
+/// (including those beyond 2^53) get a trailing `.0`, so they are read back as doubles.
+/// @param value The value to format. Has to be finite.
+/// @param out The buffer to write to. Has to provide at least number::max_formatted_length characters.
+/// @return A pointer past the last written character.
+inline char* format_double(double value, char* out)
+{
+  static const double powers_of_ten[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9};
+
+  const double magnitude = std::fabs(value);
+
+  // integral values below 2^53 are exact and do not need the round trip check
+  if (value == std::floor(value) && magnitude < 9007199254740992.0) {
+    return format_integral(value, out);
+  }
+
+  // values with only a few decimals (e.g. scaled sensor readings) are written as scaled integers. Integer and power
+  // of ten are both exact, so the division yields the same double as parsing the digits.
+  if (magnitude < 1e6) {
+    for (int decimals = 1; decimals < 10; ++decimals) {
+      const double scaled = std::round(magnitude * powers_of_ten[decimals]);
+      if (scaled / powers_of_ten[decimals] == magnitude) {
+        char digits[max_formatted_length];
+        char* end = format_uint(static_cast<uint64_t>(scaled), digits);
+        std::ptrdiff_t count = end - digits;
+        if (value < 0) {
+          *out++ = '-';
+        }
+        if (count <= decimals) {
+          *out++ = '0';
+          *out++ = '.';
+          for (std::ptrdiff_t i = count; i < decimals; ++i) {
+            *out++ = '0';
+          }
+          std::memcpy(out, digits, static_cast<std::size_t>(count));
+          return out + count;
+        }
+        std::memcpy(out, digits, static_cast<std::size_t>(count - decimals));
+        out += count - decimals;
+        *out++ = '.';
+        std::memcpy(out, end - decimals, static_cast<std::size_t>(decimals));
+        return out + decimals;
+      }
+    }
+  }
+
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+  // the standard library provides an exact shortest round trip conversion
+  return append_fraction(out, std::to_chars(out, out + max_formatted_length, value).ptr);
+#else
+  // a single conversion to 17 significant digits, the shorter candidates are derived by rounding these digits
+  char buffer[max_formatted_length];
+  std::snprintf(buffer, sizeof(buffer), "%.16e", value);
+  const bool negative = buffer[0] == '-';
+  const char* scientific = buffer + (negative ? 1 : 0);
+  char digits[17];
+  digits[0] = scientific[0];
+  std::memcpy(digits + 1, scientific + 2, 16);
+  const int exponent = std::atoi(scientific + 19);
+
+  char candidate[max_formatted_length];
+  for (int precision = 15; precision < 17; ++precision) {
+    char rounded[17];
+    int rounded_exponent = exponent;
+    std::memcpy(rounded, digits, static_cast<std::size_t>(precision));
+    if (digits[precision] >= '5') {
+      int i = precision - 1;
+      for (; i >= 0 && rounded[i] == '9'; --i) {
+        rounded[i] = '0';
+      }
+      if (i >= 0) {
+        ++rounded[i];
+      } else {
+        rounded[0] = '1';
+        ++rounded_exponent;
+      }
+    }
+
+    char* end = format_significant(negative, rounded, precision, rounded_exponent, candidate);
+    *end = '\0';
+    if (std::strtod(candidate, nullptr) == value) {
+      std::memcpy(out, candidate, static_cast<std::size_t>(end - candidate));
+      return append_fraction(out, out + (end - candidate));
+    }
+  }
+  return append_fraction(out, format_significant(negative, digits, 17, exponent, out));
+#endif
+}
+
+/// Formats a finite float as decimal number. The output is the shortest of 6 to 9 significant digits that parses
+/// back to the identical float. Every output without an exponent gets a decimal point, integral values get a trailing
+/// `.0`, so they are read back as doubles.
+/// @param value The value to format. Has to be finite.
+/// @param out The buffer to write to. Has to provide at least number::max_formatted_length characters.
+/// @return A pointer past the last written character.
+inline char* format_float(float value, char* out)
+{
+  if (value == std::floor(value) && std::fabs(value) < 16777216.0f) {
+    return format_integral(static_cast<double>(value), out);
+  }
+
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+  return append_fraction(out, std::to_chars(out, out + max_formatted_length, value).ptr);
+#else
+  char buffer[max_formatted_length];
+  int length = 0;
+  for (int precision = 6; precision <= 9; ++precision) {
+    length = std::snprintf(buffer, sizeof(buffer), "%.*g", precision, static_cast<double>(value));
+    if (precision == 9 || std::strtof(buffer, nullptr) == value) {
+      break;
+    }
+  }
+
+  std::memcpy(out, buffer, static_cast<std::size_t>(length));
+  return append_fraction(out, out + length);
+#endif
+}
+
+/// Formats a value with the matching format function.
+/// @param value The value to format.
+/// @param out The buffer to write to. Has to provide at least number::max_formatted_length characters.
+/// @return A pointer past the last written character.
+inline char* format(int64_t value, char* out)
+{
+  return format_int(value, out);
+}
+
+/// Formats a value with the matching format function.
+/// @param value The value to format.
+/// @param out The buffer to write to. Has to provide at least number::max_formatted_length characters.
+/// @return A pointer past the last written character.
+inline char* format(double value, char* out)
+{
+  return format_double(value, out);
+}
+
+/// Formats a value with the matching format function.
+/// @param value The value to format.
+/// @param out The buffer to write to. Has to provide at least number::max_formatted_length characters.
+/// @return A pointer past the last written character.
+inline char* format(float value, char* out)
+{
+  return format_float(value, out);
+}
+
+/// Appends a contiguous array of numbers as comma separated list to a string. The string is grown only once for the
+/// whole array and every number is formatted directly into it.
+/// @tparam T The number type, one of int64_t, double or float.
+/// @param values The numbers to append.
+/// @param count The number of values.
+/// @param out The string to append to.
+template <typename T>
+void append_list(const T* values, std::size_t count, std::string& out)
+{
+  if (count == 0) {
+    return;
+  }
+
+  const std::size_t start = out.size();
+  out.resize(start + count * (max_formatted_length + 1));
+
+  char* const begin = &out[0];
+  char* p = begin + start;
+  for (std::size_t i = 0; i < count; ++i) {
+    if (i != 0) {
+      *p++ = ',';
+    }
+    p = format(values[i], p);
+  }
+  out.resize(static_cast<std::size_t>(p - begin));
+}
+}
+}
+}
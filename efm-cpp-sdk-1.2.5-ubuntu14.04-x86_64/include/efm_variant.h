@@ -6,13 +6,23 @@
 
 #pragma once
 
+#include <efm_base64.h>
+#include <efm_binary_buffer.h>
 #include <efm_error_code.h>
 #include <efm_exception.h>
+#include <efm_number_format.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <cstddef>
+#include <cstring>
 #include <iomanip>
+#include <iterator>
 #include <map>
 #include <string>
+#include <system_error>
+#include <utility>
 #include <vector>
 
 namespace cisco
@@ -25,6 +35,52 @@ namespace efm_sdk
 #pragma GCC diagnostic ignored "-Wstrict-aliasing"
 #endif
 
+/// @private
+namespace detail
+{
+/// @private
+/// Mixes a value into a hash seed, used for the structural hashes of the variants.
+inline std::size_t hash_combine(std::size_t seed, uint64_t value)
+{
+  value ^= value >> 33;
+  value *= 0xFF51AFD7ED558CCDull;
+  value ^= value >> 33;
+  value *= 0xC4CEB9FE1A85EC53ull;
+  value ^= value >> 33;
+  return seed ^ (static_cast<std::size_t>(value) + 0x9E3779B97F4A7C15ull + (seed << 6) + (seed >> 2));
+}
+
+/// @private
+/// Mixes a range of bytes into a hash seed.
+inline std::size_t hash_bytes(std::size_t seed, const void* data, std::size_t length)
+{
+  const char* bytes = static_cast<const char*>(data);
+  for (; length >= sizeof(uint64_t); length -= sizeof(uint64_t), bytes += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, bytes, sizeof(word));
+    seed = hash_combine(seed, word);
+  }
+  uint64_t tail = 0;
+  if (length != 0) {
+    std::memcpy(&tail, bytes, length);
+  }
+  return hash_combine(seed, tail ^ (static_cast<uint64_t>(length) << 56));
+}
+
+/// @private
+/// Hashes a double, 0.0 and -0.0 hash alike since they compare equal.
+inline std::size_t hash_number(double value)
+{
+  if (value == 0) {
+    value = 0;
+  }
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  // 4 is the type id of doubles in the variants
+  return hash_combine(4, bits);
+}
+}
+
 /// @brief The Variant is the basic container for the value handling.
 
 /// It can stand for simple value types like a string, an integer or a double, but also for an array or map (or
@@ -35,6 +91,17 @@ namespace efm_sdk
 ///
 /// To ensure that your code is portable please always use the standardized integral type aliases (e.g. int16_t,
 /// uint32_t) to interface with this class.
+///
+/// Numeric vectors (e.g. waveforms) can be stored as typed arrays (VariantBase::DoubleArray, VariantBase::FloatArray
+/// and VariantBase::IntArray). Their values are stored contiguously instead of one variant per element. A typed array
+/// is still accepted wherever an array is expected: VariantBase::as_array converts it to a generic array on first
+/// use only.
+///
+/// The SDK library only knows the types up to VariantBase::Array. Binaries and typed arrays are handled by the header
+/// only parts of the SDK (e.g. cisco::efm_sdk::json::Writer), they must not be handed to the SDK library.
+///
+/// A variant copies its value on every copy. cisco::efm_sdk::CompactVariant is a 16 byte alternative sharing its
+/// value between copies, for values copied often within a link.
 template <uint16_t size>
 class VariantBase
 {
@@ -43,6 +110,14 @@ public:
   using ArrayType = std::vector<VariantBase<size>>;
   /// Map type for Variant maps
   using MapType = std::map<std::string, VariantBase<size>>;
+  /// Binary type for Variant binaries
+  using BinaryType = BinaryBuffer;
+  /// Array type for Variant double arrays
+  using DoubleArrayType = std::vector<double>;
+  /// Array type for Variant float arrays
+  using FloatArrayType = std::vector<float>;
+  /// Array type for Variant integer arrays
+  using IntArrayType = std::vector<int64_t>;
 
   /// Specifies the type of the variant.
   enum VariantType
@@ -54,7 +129,11 @@ public:
     Double, ///< The variant has double type. The underlying type is double.
     String, ///< The variant has string type.
     Map,    ///< The variant has map type.
-    Array   ///< The variant has array type.
+    Array,  ///< The variant has array type.
+    Binary,      ///< The variant has binary type. The underlying type is a cisco::efm_sdk::BinaryBuffer.
+    DoubleArray, ///< The variant has typed array type. The underlying type is std::vector<double>.
+    FloatArray,  ///< The variant has typed array type. The underlying type is std::vector<float>.
+    IntArray     ///< The variant has typed array type. The underlying type is std::vector<int64_t>.
   };
 
   /// Constructs an empty variant. VariantBase::is_null will be true. The type will be VariantBase::Null.
@@ -74,6 +153,10 @@ public:
   /// | String       |     empty     |
   /// | Map          |       -       |
   /// | Array        |       -       |
+  /// | Binary       |     empty     |
+  /// | DoubleArray  |     empty     |
+  /// | FloatArray   |     empty     |
+  /// | IntArray     |     empty     |
   /// @param type The type to create a variant for.
   VariantBase(VariantType type)
     : type_(type)
@@ -167,7 +250,8 @@ public:
   /// Constructs a variant of double type. VariantBase::is_null will be false. The type will be VariantBase::Double.
   /// VariantBase::as_double will return the given value.
   /// @param f The float value to set the variant to.
-  /// @throw cisco::efm_sdk::exception If value is NaN (not a number) or Infinity
+  /// @throw cisco::efm_sdk::exception If value is NaN (not a number) or Infinity. Use VariantBase::make_double to
+  /// create a variant without throwing.
   VariantBase(float f)
     : type_(Double)
   {
@@ -180,7 +264,8 @@ public:
   /// Constructs a variant of double type. VariantBase::is_null will be false. The type will be VariantBase::Double.
   /// VariantBase::as_double will return the given value.
   /// @param f The float value to set the variant to.
-  /// @throw cisco::efm_sdk::exception If value is NaN (not a number) or Infinity
+  /// @throw cisco::efm_sdk::exception If value is NaN (not a number) or Infinity. Use VariantBase::make_double to
+  /// create a variant without throwing.
   VariantBase(double f)
     : type_(Double)
   {
@@ -190,13 +275,41 @@ public:
     new (raw_) double(f);
   }
 
+  /// Creates a variant of double type without throwing. If the value is NaN (not a number) or Infinity, a
+  /// VariantBase::Null variant will be returned and the error code will be set.
+  /// @param f The float value to set the variant to.
+  /// @param ec Will be set to an error if the value is not finite.
+  /// @return The created variant.
+  static VariantBase make_double(float f, std::error_code& ec)
+  {
+    return make_double(static_cast<double>(f), ec);
+  }
+
+  /// Creates a variant of double type without throwing. If the value is NaN (not a number) or Infinity, a
+  /// VariantBase::Null variant will be returned and the error code will be set.
+  /// @param f The double value to set the variant to.
+  /// @param ec Will be set to an error if the value is not finite.
+  /// @return The created variant.
+  static VariantBase make_double(double f, std::error_code& ec)
+  {
+    VariantBase v;
+    if (!std::isfinite(f)) {
+      ec = make_error_code(error_code::efm_variant_error);
+      return v;
+    }
+    ec.clear();
+    v.type_ = Double;
+    new (v.raw_) double(f);
+    return v;
+  }
+
   /// Constructs a variant of string type. VariantBase::is_null will be false. The type will be VariantBase::String.
   /// VariantBase::as_string will return the given value.
   /// @param s The string value to set the variant to.
   VariantBase(const std::string& s)
     : type_(String)
   {
-    new (raw_) std::string(s);
+    create<std::string>(s);
   }
 
   /// Constructs a variant of string type. VariantBase::is_null will be false. The type will be VariantBase::String.
@@ -205,7 +318,7 @@ public:
   VariantBase(std::string&& s)
     : type_(String)
   {
-    new (raw_) std::string(std::move(s));
+    create<std::string>(std::move(s));
   }
 
   /// Constructs a variant from a char pointer.
@@ -222,7 +335,7 @@ public:
   {
     if (s != nullptr) {
       type_ = String;
-      new (raw_) std::string(s);
+      create<std::string>(s);
     }
   }
 
@@ -240,7 +353,7 @@ public:
   {
     if (s != nullptr) {
       type_ = String;
-      new (raw_) std::string(s);
+      create<std::string>(s);
     }
   }
 
@@ -252,7 +365,7 @@ public:
   VariantBase(const char (&s)[char_count])
     : type_(String)
   {
-    new (raw_) std::string(s);
+    create<std::string>(s);
   }
 
   /// Constructs a variant of array type. VariantBase::is_null will be false. The type will be VariantBase::Array.
@@ -261,7 +374,7 @@ public:
   VariantBase(const ArrayType& array)
     : type_(Array)
   {
-    new (raw_) ArrayType(array);
+    create<ArrayType>(array);
   }
 
   /// Constructs a variant of array type. VariantBase::is_null will be false. The type will be VariantBase::Array.
@@ -270,7 +383,7 @@ public:
   VariantBase(ArrayType&& array)
     : type_(Array)
   {
-    new (raw_) ArrayType(std::move(array));
+    create<ArrayType>(std::move(array));
   }
 
   /// Constructs a variant of map type. VariantBase::is_null will be false. The type will be VariantBase::Map.
@@ -279,7 +392,7 @@ public:
   VariantBase(const MapType& map)
     : type_(Map)
   {
-    new (raw_) MapType(map);
+    create<MapType>(map);
   }
 
   /// Constructs a variant of map type. VariantBase::is_null will be false. The type will be VariantBase::Map.
@@ -288,7 +401,123 @@ public:
   VariantBase(MapType&& map)
     : type_(Map)
   {
-    new (raw_) MapType(std::move(map));
+    create<MapType>(std::move(map));
+  }
+
+  /// Constructs a variant of binary type. VariantBase::is_null will be false. The type will be VariantBase::Binary.
+  /// VariantBase::as_binary will return the given value. The bytes of the buffer are not copied.
+  ///
+  /// Binaries are supported by cisco::efm_sdk::json::Writer, which writes them as DSA binary string, and by
+  /// cisco::efm_sdk::msgpack::encode. Values handed to the SDK library (e.g. cisco::efm_sdk::Responder::set_value or
+  /// cisco::efm_sdk::json::to_json_string) have to be encoded as DSA binary string first, see
+  /// cisco::efm_sdk::encode_dsa_binary.
+  /// @param binary The binary to set the variant to.
+  VariantBase(const BinaryType& binary)
+    : type_(Binary)
+  {
+    create<BinaryType>(binary);
+  }
+
+  /// Constructs a variant of binary type. VariantBase::is_null will be false. The type will be VariantBase::Binary.
+  /// VariantBase::as_binary will return the given value. The bytes of the buffer are not copied.
+  ///
+  /// Binaries are supported by cisco::efm_sdk::json::Writer, which writes them as DSA binary string, and by
+  /// cisco::efm_sdk::msgpack::encode. Values handed to the SDK library (e.g. cisco::efm_sdk::Responder::set_value or
+  /// cisco::efm_sdk::json::to_json_string) have to be encoded as DSA binary string first, see
+  /// cisco::efm_sdk::encode_dsa_binary.
+  /// @param binary The binary to set the variant to.
+  VariantBase(BinaryType&& binary)
+    : type_(Binary)
+  {
+    create<BinaryType>(std::move(binary));
+  }
+
+  /// Constructs a variant of typed array type. VariantBase::is_null will be false. The type will be
+  /// VariantBase::DoubleArray. VariantBase::as_double_array will return the given values.
+  /// @param array The values to set the variant to.
+  /// @throw cisco::efm_sdk::exception If one of the values is NaN (not a number) or Infinity. Use
+  /// VariantBase::make_double_array to create a variant without throwing.
+  VariantBase(const DoubleArrayType& array)
+    : type_(DoubleArray)
+  {
+    check_finite(array);
+    create_typed_array<double>(array);
+  }
+
+  /// Constructs a variant of typed array type. VariantBase::is_null will be false. The type will be
+  /// VariantBase::DoubleArray. VariantBase::as_double_array will return the given values.
+  /// @param array The values to set the variant to.
+  /// @throw cisco::efm_sdk::exception If one of the values is NaN (not a number) or Infinity. Use
+  /// VariantBase::make_double_array to create a variant without throwing.
+  VariantBase(DoubleArrayType&& array)
+    : type_(DoubleArray)
+  {
+    check_finite(array);
+    create_typed_array<double>(std::move(array));
+  }
+
+  /// Constructs a variant of typed array type. VariantBase::is_null will be false. The type will be
+  /// VariantBase::FloatArray. VariantBase::as_float_array will return the given values.
+  /// @param array The values to set the variant to.
+  /// @throw cisco::efm_sdk::exception If one of the values is NaN (not a number) or Infinity. Use
+  /// VariantBase::make_float_array to create a variant without throwing.
+  VariantBase(const FloatArrayType& array)
+    : type_(FloatArray)
+  {
+    check_finite(array);
+    create_typed_array<float>(array);
+  }
+
+  /// Constructs a variant of typed array type. VariantBase::is_null will be false. The type will be
+  /// VariantBase::FloatArray. VariantBase::as_float_array will return the given values.
+  /// @param array The values to set the variant to.
+  /// @throw cisco::efm_sdk::exception If one of the values is NaN (not a number) or Infinity. Use
+  /// VariantBase::make_float_array to create a variant without throwing.
+  VariantBase(FloatArrayType&& array)
+    : type_(FloatArray)
+  {
+    check_finite(array);
+    create_typed_array<float>(std::move(array));
+  }
+
+  /// Creates a variant of typed array type VariantBase::DoubleArray without throwing on invalid values. If one of the
+  /// values is NaN (not a number) or Infinity, a VariantBase::Null variant will be returned and the error code will be
+  /// set.
+  /// @param array The values to set the variant to.
+  /// @param ec Will be set to an error if one of the values is not finite.
+  /// @return The created variant.
+  static VariantBase make_double_array(DoubleArrayType array, std::error_code& ec)
+  {
+    return make_typed_array(std::move(array), DoubleArray, ec);
+  }
+
+  /// Creates a variant of typed array type VariantBase::FloatArray without throwing on invalid values. If one of the
+  /// values is NaN (not a number) or Infinity, a VariantBase::Null variant will be returned and the error code will be
+  /// set.
+  /// @param array The values to set the variant to.
+  /// @param ec Will be set to an error if one of the values is not finite.
+  /// @return The created variant.
+  static VariantBase make_float_array(FloatArrayType array, std::error_code& ec)
+  {
+    return make_typed_array(std::move(array), FloatArray, ec);
+  }
+
+  /// Constructs a variant of typed array type. VariantBase::is_null will be false. The type will be
+  /// VariantBase::IntArray. VariantBase::as_int_array will return the given values.
+  /// @param array The values to set the variant to.
+  VariantBase(const IntArrayType& array)
+    : type_(IntArray)
+  {
+    create_typed_array<int64_t>(array);
+  }
+
+  /// Constructs a variant of typed array type. VariantBase::is_null will be false. The type will be
+  /// VariantBase::IntArray. VariantBase::as_int_array will return the given values.
+  /// @param array The values to set the variant to.
+  VariantBase(IntArrayType&& array)
+    : type_(IntArray)
+  {
+    create_typed_array<int64_t>(std::move(array));
   }
 
   /// Destroys the variant
@@ -299,56 +528,18 @@ public:
 
   /// Constructs a variant from another variant, moving its internal representation.
   /// @param other Variant to move into this variant.
-  VariantBase(VariantBase<size>&& other)
-    : type_(other.type_)
+  VariantBase(VariantBase<size>&& other) noexcept
+    : type_(Null)
   {
-    other.type_ = Null;
-
-    switch (type_) {
-      case Null:
-        break;
-      case Bool:
-      case Int:
-      case UInt:
-      case Double:
-        std::copy(other.raw_, other.raw_ + size, raw_);
-        break;
-      case String:
-        new (raw_) std::string(std::move(*reinterpret_cast<std::string*>(other.raw_)));
-        break;
-      case Array:
-        new (raw_) ArrayType(std::move(*reinterpret_cast<ArrayType*>(other.raw_)));
-        break;
-      case Map:
-        new (raw_) MapType(std::move(*reinterpret_cast<MapType*>(other.raw_)));
-        break;
-    }
+    move_from(other);
   }
 
   /// Constructs a variant from another variant.
   /// @param other The variant to use to initialize this variant.
   VariantBase(const VariantBase<size>& other)
-    : type_(other.type_)
+    : type_(Null)
   {
-    switch (other.type_) {
-      case Null:
-        break;
-      case Bool:
-      case Int:
-      case UInt:
-      case Double:
-        std::copy(other.raw_, other.raw_ + size, raw_);
-        break;
-      case String:
-        new (raw_) std::string(other.as_string());
-        break;
-      case Array:
-        new (raw_) ArrayType(other.as_array());
-        break;
-      case Map:
-        new (raw_) MapType(other.as_map());
-        break;
-    }
+    copy_from(other);
   }
 
   /// Assigns the given variant to this one.
@@ -361,61 +552,21 @@ public:
     }
 
     destroy();
-    type_ = other.type_;
-    switch (other.type_) {
-      case Null:
-        break;
-      case Bool:
-      case Int:
-      case UInt:
-      case Double:
-        std::copy(other.raw_, other.raw_ + size, raw_);
-        break;
-      case String:
-        new (raw_) std::string(other.as_string());
-        break;
-      case Array:
-        new (raw_) ArrayType(other.as_array());
-        break;
-      case Map:
-        new (raw_) MapType(other.as_map());
-        break;
-    }
+    copy_from(other);
     return *this;
   }
 
   /// Assigns the given moved variant to this one.
   /// @param other The moved variant to assign to this one.
   /// @return A reference to this variant.
-  VariantBase& operator=(VariantBase<size>&& other)
+  VariantBase& operator=(VariantBase<size>&& other) noexcept
   {
     if (this == &other) {
       return *this;
     }
 
     destroy();
-    type_ = other.type_;
-    other.type_ = Null;
-
-    switch (type_) {
-      case Null:
-        break;
-      case Bool:
-      case Int:
-      case UInt:
-      case Double:
-        std::copy(other.raw_, other.raw_ + size, raw_);
-        break;
-      case String:
-        new (raw_) std::string(std::move(*reinterpret_cast<std::string*>(other.raw_)));
-        break;
-      case Array:
-        new (raw_) ArrayType(std::move(*reinterpret_cast<ArrayType*>(other.raw_)));
-        break;
-      case Map:
-        new (raw_) MapType(std::move(*reinterpret_cast<MapType*>(other.raw_)));
-        break;
-    }
+    move_from(other);
     return *this;
   }
 
@@ -435,6 +586,54 @@ public:
     return !equals(other);
   }
 
+  /// Computes a structural hash of the variant. Variants comparing equal have the same hash, e.g. an integer and an
+  /// unsigned integer of the same value or a typed array and a generic array with the same elements.
+  ///
+  /// The hash is computed on every call by walking the whole value. cisco::efm_sdk::CompactVariant caches the hash of
+  /// its values.
+  /// @return The hash of the variant.
+  std::size_t hash() const
+  {
+    switch (type_) {
+      case Null:
+        break;
+      case Bool:
+        return detail::hash_combine(Bool, *reinterpret_cast<const bool*>(raw_) ? 1 : 0);
+      case Int:
+      case UInt:
+        return detail::hash_combine(Int, *reinterpret_cast<const uint64_t*>(raw_));
+      case Double:
+        return detail::hash_number(*reinterpret_cast<const double*>(raw_));
+      case String:
+        return detail::hash_bytes(String, value<std::string>().data(), value<std::string>().size());
+      case Array:
+        return hash_elements(value<ArrayType>());
+      case Map:
+        return hash_map(value<MapType>());
+      case Binary:
+        return detail::hash_bytes(Binary, value<BinaryType>().data(), value<BinaryType>().size());
+      case DoubleArray:
+        return hash_elements(typed_array<double>().values_);
+      case FloatArray:
+        return hash_elements(typed_array<float>().values_);
+      case IntArray:
+        return hash_elements(typed_array<int64_t>().values_);
+    }
+    return detail::hash_combine(Null, 0);
+  }
+
+  /// Computes a hash value for a variant, see VariantBase::hash.
+  struct Hash
+  {
+    /// Computes a hash value for a variant.
+    /// @param value The variant to compute the hash for.
+    /// @return The computed hash.
+    std::size_t operator()(const VariantBase<size>& value) const
+    {
+      return value.hash();
+    }
+  };
+
   /// Checks if the variant is of null type.
   /// @return true if it is of null type, otherwise false.
   bool is_null() const
@@ -501,18 +700,28 @@ public:
     if (type_ != String) {
       throw exception(error_code::efm_variant_error, "not a string");
     }
-    return *reinterpret_cast<const std::string*>(raw_);
+    return value<std::string>();
   }
 
-  /// Returns a non-mutable array of variants if the variants type is VariantBase::Array.
-  /// @exception If the type is not VariantBase::Array.
+  /// Returns a non-mutable array of variants if the variants type is VariantBase::Array or one of the typed array
+  /// types. A typed array is converted to a generic array on the first call, the conversion is kept as long as the
+  /// typed array exists.
+  /// @exception If the type is not VariantBase::Array or a typed array.
   /// @return An array of variants.
   const ArrayType& as_array() const
   {
-    if (type_ != Array) {
-      throw exception(error_code::efm_variant_error, "not an array");
+    switch (type_) {
+      case Array:
+        return value<ArrayType>();
+      case DoubleArray:
+        return typed_array<double>().generic();
+      case FloatArray:
+        return typed_array<float>().generic();
+      case IntArray:
+        return typed_array<int64_t>().generic();
+      default:
+        throw exception(error_code::efm_variant_error, "not an array");
     }
-    return *reinterpret_cast<const ArrayType*>(raw_);
   }
 
   /// Returns a non-mutable map of variants if the variants type is VariantBase::Map.
@@ -523,18 +732,71 @@ public:
     if (type_ != Map) {
       throw exception(error_code::efm_variant_error, "not a map");
     }
-    return *reinterpret_cast<const MapType*>(raw_);
+    return value<MapType>();
   }
 
-  /// Returns a mutable array of variants if the variants type is VariantBase::Array.
-  /// @exception If the type is not VariantBase::Array.
+  /// Returns the binary value of the variant if the variants type is VariantBase::Binary. Binaries are immutable.
+  /// @exception If the type is not VariantBase::Binary.
+  /// @return The binary value of the variant.
+  const BinaryType& as_binary() const
+  {
+    if (type_ != Binary) {
+      throw exception(error_code::efm_variant_error, "not a binary");
+    }
+    return value<BinaryType>();
+  }
+
+  /// Returns the values of the variant if the variants type is VariantBase::DoubleArray. Typed arrays are immutable.
+  /// @exception If the type is not VariantBase::DoubleArray.
+  /// @return The values of the variant.
+  const DoubleArrayType& as_double_array() const
+  {
+    if (type_ != DoubleArray) {
+      throw exception(error_code::efm_variant_error, "not a double array");
+    }
+    return typed_array<double>().values_;
+  }
+
+  /// Returns the values of the variant if the variants type is VariantBase::FloatArray. Typed arrays are immutable.
+  /// @exception If the type is not VariantBase::FloatArray.
+  /// @return The values of the variant.
+  const FloatArrayType& as_float_array() const
+  {
+    if (type_ != FloatArray) {
+      throw exception(error_code::efm_variant_error, "not a float array");
+    }
+    return typed_array<float>().values_;
+  }
+
+  /// Returns the values of the variant if the variants type is VariantBase::IntArray. Typed arrays are immutable.
+  /// @exception If the type is not VariantBase::IntArray.
+  /// @return The values of the variant.
+  const IntArrayType& as_int_array() const
+  {
+    if (type_ != IntArray) {
+      throw exception(error_code::efm_variant_error, "not an int array");
+    }
+    return typed_array<int64_t>().values_;
+  }
+
+  /// Returns a mutable array of variants if the variants type is VariantBase::Array. A typed array is converted to a
+  /// generic array and the type of the variant changes to VariantBase::Array.
+  /// @exception If the type is not VariantBase::Array or a typed array.
   /// @return An array of variants.
   ArrayType& as_array()
   {
-    if (type_ != Array) {
-      throw exception(error_code::efm_variant_error, "not an array");
+    switch (type_) {
+      case Array:
+        return value<ArrayType>();
+      case DoubleArray:
+        return convert_to_array<double>();
+      case FloatArray:
+        return convert_to_array<float>();
+      case IntArray:
+        return convert_to_array<int64_t>();
+      default:
+        throw exception(error_code::efm_variant_error, "not an array");
     }
-    return *reinterpret_cast<ArrayType*>(raw_);
   }
 
   /// Returns a mutable map of variants if the variants type is VariantBase::Map.
@@ -545,7 +807,166 @@ public:
     if (type_ != Map) {
       throw exception(error_code::efm_variant_error, "not a map");
     }
-    return *reinterpret_cast<MapType*>(raw_);
+    return value<MapType>();
+  }
+
+  /// Retrieves the boolean value of the variant without throwing.
+  /// @param value Will be set to the value if the variants type is VariantBase::Bool.
+  /// @return true if the variants type is VariantBase::Bool, otherwise false.
+  bool try_as_bool(bool& value) const noexcept
+  {
+    if (type_ != Bool) {
+      return false;
+    }
+    value = *reinterpret_cast<const bool*>(raw_);
+    return true;
+  }
+
+  /// Retrieves the integer value of the variant without throwing.
+  /// @param value Will be set to the value if the variants type is VariantBase::Int or VariantBase::UInt.
+  /// @return true if the variants type is VariantBase::Int or VariantBase::UInt, otherwise false.
+  bool try_as_int(int64_t& value) const noexcept
+  {
+    if (type_ != Int && type_ != UInt) {
+      return false;
+    }
+    value = *reinterpret_cast<const int64_t*>(raw_);
+    return true;
+  }
+
+  /// Retrieves the unsigned integer value of the variant without throwing.
+  /// @param value Will be set to the value if the variants type is VariantBase::UInt or VariantBase::Int.
+  /// @return true if the variants type is VariantBase::UInt or VariantBase::Int, otherwise false.
+  bool try_as_uint(uint64_t& value) const noexcept
+  {
+    if (type_ != UInt && type_ != Int) {
+      return false;
+    }
+    value = *reinterpret_cast<const uint64_t*>(raw_);
+    return true;
+  }
+
+  /// Retrieves the double value of the variant without throwing.
+  /// @param value Will be set to the value if the variants type is VariantBase::Double.
+  /// @return true if the variants type is VariantBase::Double, otherwise false.
+  bool try_as_double(double& value) const noexcept
+  {
+    if (type_ != Double) {
+      return false;
+    }
+    value = *reinterpret_cast<const double*>(raw_);
+    return true;
+  }
+
+  /// Returns the string value of the variant without throwing.
+  /// @return A pointer to the string if the variants type is VariantBase::String, otherwise a nullptr.
+  const std::string* get_if_string() const noexcept
+  {
+    return type_ == String ? &value<std::string>() : nullptr;
+  }
+
+  /// Returns a non-mutable array of variants without throwing if the variant is not an array. A typed array is
+  /// converted like in VariantBase::as_array, the conversion allocates and may throw std::bad_alloc.
+  /// @return A pointer to the array if the variants type is VariantBase::Array or a typed array, otherwise a nullptr.
+  const ArrayType* get_if_array() const
+  {
+    return is_array() ? &as_array() : nullptr;
+  }
+
+  /// Returns a non-mutable map of variants without throwing.
+  /// @return A pointer to the map if the variants type is VariantBase::Map, otherwise a nullptr.
+  const MapType* get_if_map() const noexcept
+  {
+    return type_ == Map ? &value<MapType>() : nullptr;
+  }
+
+  /// Returns the binary value of the variant without throwing.
+  /// @return A pointer to the binary if the variants type is VariantBase::Binary, otherwise a nullptr.
+  const BinaryType* get_if_binary() const noexcept
+  {
+    return type_ == Binary ? &value<BinaryType>() : nullptr;
+  }
+
+  /// Returns the values of a typed array without throwing.
+  /// @return A pointer to the values if the variants type is VariantBase::DoubleArray, otherwise a nullptr.
+  const DoubleArrayType* get_if_double_array() const noexcept
+  {
+    return type_ == DoubleArray ? &typed_array<double>().values_ : nullptr;
+  }
+
+  /// Returns the values of a typed array without throwing.
+  /// @return A pointer to the values if the variants type is VariantBase::FloatArray, otherwise a nullptr.
+  const FloatArrayType* get_if_float_array() const noexcept
+  {
+    return type_ == FloatArray ? &typed_array<float>().values_ : nullptr;
+  }
+
+  /// Returns the values of a typed array without throwing.
+  /// @return A pointer to the values if the variants type is VariantBase::IntArray, otherwise a nullptr.
+  const IntArrayType* get_if_int_array() const noexcept
+  {
+    return type_ == IntArray ? &typed_array<int64_t>().values_ : nullptr;
+  }
+
+  /// Checks if the variant is an array, either a generic or a typed one.
+  /// @return true if the variants type is VariantBase::Array or one of the typed array types, otherwise false.
+  bool is_array() const noexcept
+  {
+    return type_ == Array || type_ == DoubleArray || type_ == FloatArray || type_ == IntArray;
+  }
+
+  /// Calls the visitor with the value of the variant. The dispatch is a plain switch over the type of the variant,
+  /// no virtual calls are involved. The visitor has to be callable with each of the following argument types and
+  /// return the same type for all of them:
+  /// | Variant Type | Argument type          |
+  /// | :----------: | :--------------------: |
+  /// | Null         | std::nullptr_t         |
+  /// | Bool         | bool                   |
+  /// | Int          | int64_t                |
+  /// | UInt         | uint64_t               |
+  /// | Double       | double                 |
+  /// | String       | const std::string&     |
+  /// | Map          | const MapType&         |
+  /// | Array        | const ArrayType&       |
+  /// | Binary       | const BinaryType&      |
+  /// | DoubleArray  | const DoubleArrayType& |
+  /// | FloatArray   | const FloatArrayType&  |
+  /// | IntArray     | const IntArrayType&    |
+  ///
+  /// Typed arrays are handed over as they are, so a visitor can process the contiguous values directly.
+  /// @tparam Visitor The type of the visitor.
+  /// @param visitor The visitor to call.
+  /// @return The result of the visitor call.
+  template <typename Visitor>
+  auto visit(Visitor&& visitor) const -> decltype(std::forward<Visitor>(visitor)(nullptr))
+  {
+    switch (type_) {
+      case Null:
+        break;
+      case Bool:
+        return std::forward<Visitor>(visitor)(*reinterpret_cast<const bool*>(raw_));
+      case Int:
+        return std::forward<Visitor>(visitor)(*reinterpret_cast<const int64_t*>(raw_));
+      case UInt:
+        return std::forward<Visitor>(visitor)(*reinterpret_cast<const uint64_t*>(raw_));
+      case Double:
+        return std::forward<Visitor>(visitor)(*reinterpret_cast<const double*>(raw_));
+      case String:
+        return std::forward<Visitor>(visitor)(value<std::string>());
+      case Array:
+        return std::forward<Visitor>(visitor)(value<ArrayType>());
+      case Map:
+        return std::forward<Visitor>(visitor)(value<MapType>());
+      case Binary:
+        return std::forward<Visitor>(visitor)(value<BinaryType>());
+      case DoubleArray:
+        return std::forward<Visitor>(visitor)(typed_array<double>().values_);
+      case FloatArray:
+        return std::forward<Visitor>(visitor)(typed_array<float>().values_);
+      case IntArray:
+        return std::forward<Visitor>(visitor)(typed_array<int64_t>().values_);
+    }
+    return std::forward<Visitor>(visitor)(nullptr);
   }
 
   /// Retrieves a mutable element at the given array index position if the variants type is VariantBase::Array.
@@ -653,6 +1074,49 @@ public:
   }
 
 private:
+  /// @private
+  /// The values of a typed array together with the generic array created from them on demand. Typed arrays are held
+  /// behind a pointer, the storage of a variant is not aligned for the atomic.
+  template <typename T>
+  struct TypedArray
+  {
+    explicit TypedArray(const std::vector<T>& values)
+      : values_(values)
+    {
+    }
+
+    explicit TypedArray(std::vector<T>&& values)
+      : values_(std::move(values))
+    {
+    }
+
+    TypedArray(const TypedArray&) = delete;
+    TypedArray& operator=(const TypedArray&) = delete;
+
+    ~TypedArray()
+    {
+      delete generic_.load(std::memory_order_acquire);
+    }
+
+    const ArrayType& generic() const
+    {
+      ArrayType* array = generic_.load(std::memory_order_acquire);
+      if (array == nullptr) {
+        ArrayType* created = new ArrayType(values_.begin(), values_.end());
+        // a const variant may be read from several threads, the first conversion wins
+        if (generic_.compare_exchange_strong(array, created, std::memory_order_acq_rel)) {
+          array = created;
+        } else {
+          delete created;
+        }
+      }
+      return *array;
+    }
+
+    std::vector<T> values_;
+    mutable std::atomic<ArrayType*> generic_{nullptr};
+  };
+
   inline void create_default(VariantType type)
   {
     switch (type) {
@@ -671,23 +1135,31 @@ private:
         new (raw_) double(0.0);
         break;
       case String:
-        new (raw_) std::string();
+        create<std::string>();
         break;
       case Map:
-        new (raw_) MapType();
+        create<MapType>();
         break;
       case Array:
-        new (raw_) ArrayType();
+        create<ArrayType>();
+        break;
+      case Binary:
+        create<BinaryType>();
+        break;
+      case DoubleArray:
+        create_typed_array<double>(DoubleArrayType());
+        break;
+      case FloatArray:
+        create_typed_array<float>(FloatArrayType());
+        break;
+      case IntArray:
+        create_typed_array<int64_t>(IntArrayType());
         break;
     }
   }
 
   void destroy()
   {
-    using std::map;
-    using std::string;
-    using std::vector;
-
     switch (type_) {
       case Null:
       case Bool:
@@ -696,26 +1168,225 @@ private:
       case Double:
         // do nothing
         break;
-      case String: {
-        std::string& s = *reinterpret_cast<std::string*>(raw_);
-        s.~string();
+      case String:
+        value<std::string>().~basic_string();
+        break;
+      case Array:
+        value<ArrayType>().~vector();
         break;
-      }
-      case Array: {
-        ArrayType& v = *reinterpret_cast<ArrayType*>(raw_);
-        v.~vector<VariantBase<size>>();
+      case Map:
+        value<MapType>().~map();
         break;
-      }
-      case Map: {
-        MapType& m = *reinterpret_cast<MapType*>(raw_);
-        m.~map<std::string, VariantBase<size>>();
+      case Binary:
+        value<BinaryType>().~BinaryType();
+        break;
+      case DoubleArray:
+        delete &typed_array<double>();
+        break;
+      case FloatArray:
+        delete &typed_array<float>();
+        break;
+      case IntArray:
+        delete &typed_array<int64_t>();
+        break;
+    }
+    type_ = Null;
+  }
+
+  // expects this variant to be destroyed
+  void copy_from(const VariantBase<size>& other)
+  {
+    switch (other.type_) {
+      case Null:
+        break;
+      case Bool:
+      case Int:
+      case UInt:
+      case Double:
+        std::copy(other.raw_, other.raw_ + size, raw_);
+        break;
+      case String:
+        create<std::string>(other.value<std::string>());
+        break;
+      case Array:
+        create<ArrayType>(other.value<ArrayType>());
+        break;
+      case Map:
+        create<MapType>(other.value<MapType>());
+        break;
+      case Binary:
+        create<BinaryType>(other.value<BinaryType>());
+        break;
+      case DoubleArray:
+        create_typed_array<double>(other.typed_array<double>().values_);
+        break;
+      case FloatArray:
+        create_typed_array<float>(other.typed_array<float>().values_);
+        break;
+      case IntArray:
+        create_typed_array<int64_t>(other.typed_array<int64_t>().values_);
+        break;
+    }
+    type_ = other.type_;
+  }
+
+  // expects this variant to be destroyed
+  void move_from(VariantBase<size>& other) noexcept
+  {
+    switch (other.type_) {
+      case Null:
+        break;
+      case Bool:
+      case Int:
+      case UInt:
+      case Double:
+      case DoubleArray:
+      case FloatArray:
+      case IntArray:
+        // the typed array pointer is handed over
+        std::copy(other.raw_, other.raw_ + size, raw_);
+        break;
+      case String:
+        create<std::string>(std::move(other.value<std::string>()));
+        other.value<std::string>().~basic_string();
+        break;
+      case Array:
+        create<ArrayType>(std::move(other.value<ArrayType>()));
+        other.value<ArrayType>().~vector();
         break;
+      case Map:
+        create<MapType>(std::move(other.value<MapType>()));
+        other.value<MapType>().~map();
+        break;
+      case Binary:
+        create<BinaryType>(std::move(other.value<BinaryType>()));
+        other.value<BinaryType>().~BinaryType();
+        break;
+    }
+    type_ = other.type_;
+    other.type_ = Null;
+  }
+
+  template <typename T, typename... Args>
+  void create(Args&&... args)
+  {
+    new (raw_) T(std::forward<Args>(args)...);
+  }
+
+  template <typename T, typename Values>
+  void create_typed_array(Values&& values)
+  {
+    new (raw_) TypedArray<T>*(new TypedArray<T>(std::forward<Values>(values)));
+  }
+
+  template <typename T>
+  T& value()
+  {
+    return *reinterpret_cast<T*>(raw_);
+  }
+
+  template <typename T>
+  const T& value() const
+  {
+    return *reinterpret_cast<const T*>(raw_);
+  }
+
+  template <typename T>
+  TypedArray<T>& typed_array() const
+  {
+    return **reinterpret_cast<TypedArray<T>* const*>(raw_);
+  }
+
+  template <typename T>
+  ArrayType& convert_to_array()
+  {
+    ArrayType array(typed_array<T>().generic());
+    destroy();
+    create<ArrayType>(std::move(array));
+    type_ = Array;
+    return value<ArrayType>();
+  }
+
+  template <typename T>
+  static bool all_finite(const std::vector<T>& values)
+  {
+    for (T value : values) {
+      if (!std::isfinite(value)) {
+        return false;
       }
     }
+    return true;
+  }
+
+  template <typename T>
+  static void check_finite(const std::vector<T>& values)
+  {
+    if (!all_finite(values)) {
+      throw exception(error_code::efm_variant_error, "not a valid number array");
+    }
+  }
+
+  template <typename T>
+  static VariantBase make_typed_array(std::vector<T>&& values, VariantType type, std::error_code& ec)
+  {
+    VariantBase v;
+    if (!all_finite(values)) {
+      ec = make_error_code(error_code::efm_variant_error);
+      return v;
+    }
+    ec.clear();
+    v.create_typed_array<T>(std::move(values));
+    v.type_ = type;
+    return v;
+  }
+
+  static std::size_t element_hash(double value)
+  {
+    return detail::hash_number(value);
+  }
+
+  static std::size_t element_hash(float value)
+  {
+    return detail::hash_number(static_cast<double>(value));
+  }
+
+  static std::size_t element_hash(int64_t value)
+  {
+    return detail::hash_combine(Int, static_cast<uint64_t>(value));
+  }
+
+  static std::size_t element_hash(const VariantBase<size>& value)
+  {
+    return value.hash();
+  }
+
+  template <typename T>
+  static std::size_t hash_elements(const std::vector<T>& value)
+  {
+    // all kinds of arrays hash alike, since typed and generic arrays may compare equal
+    std::size_t seed = detail::hash_combine(Array, value.size());
+    for (const auto& element : value) {
+      seed = detail::hash_combine(seed, element_hash(element));
+    }
+    return seed;
+  }
+
+  static std::size_t hash_map(const MapType& value)
+  {
+    std::size_t seed = detail::hash_combine(Map, value.size());
+    for (const auto& element : value) {
+      seed = detail::hash_bytes(seed, element.first.data(), element.first.size());
+      seed = detail::hash_combine(seed, element.second.hash());
+    }
+    return seed;
   }
 
   bool equals(const VariantBase<size>& other) const
   {
+    if (this->type() != other.type() && this->is_array() && other.is_array()) {
+      return as_array() == other.as_array();
+    }
+
     if (this->type() != other.type()) {
       if (!((this->type() == UInt && other.type() == Int) || (this->type() == Int && other.type() == UInt))) {
         return false;
@@ -736,9 +1407,17 @@ private:
       case String:
         return as_string() == other.as_string();
       case Array:
-        return as_array() == other.as_array();
+        return value<ArrayType>() == other.value<ArrayType>();
       case Map:
-        return as_map() == other.as_map();
+        return value<MapType>() == other.value<MapType>();
+      case Binary:
+        return value<BinaryType>() == other.value<BinaryType>();
+      case DoubleArray:
+        return typed_array<double>().values_ == other.typed_array<double>().values_;
+      case FloatArray:
+        return typed_array<float>().values_ == other.typed_array<float>().values_;
+      case IntArray:
+        return typed_array<int64_t>().values_ == other.typed_array<int64_t>().values_;
     }
     return false;
   }
@@ -766,6 +1445,26 @@ struct VariantHelper
 /// @private
 using Variant = VariantBase<sizeof(VariantHelper::sizer)>;
 
+static_assert(sizeof(Variant::BinaryType) <= sizeof(VariantHelper::sizer), "a binary has to fit into a Variant");
+
+/// @private
+namespace detail
+{
+/// @private
+/// Builds a map from decoded members. The last of several members with the same key wins, like assigning the members
+/// one after another.
+inline Variant::MapType make_map(std::vector<std::pair<std::string, Variant>>&& members)
+{
+  Variant::MapType map;
+  for (auto& member : members) {
+    // the members of a message are mostly sorted already, inserting them at the end is then constant per member
+    auto it = map.emplace_hint(map.end(), std::move(member.first), Variant());
+    it->second = std::move(member.second);
+  }
+  return map;
+}
+}
+
 /// stream insertion operator for VariantType
 ///
 /// @tparam CharT Character type for the ostream
@@ -795,8 +1494,14 @@ std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>&
       os << "map";
       break;
     case Variant::VariantType::Array:
+    case Variant::VariantType::DoubleArray:
+    case Variant::VariantType::FloatArray:
+    case Variant::VariantType::IntArray:
       os << "array";
       break;
+    case Variant::VariantType::Binary:
+      os << "binary";
+      break;
   }
 
   return os;
@@ -848,6 +1553,34 @@ std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>&
     case Variant::String:
       os << "\"" << value.as_string() << "\"";
       break;
+    case Variant::Binary: {
+      const Variant::BinaryType& binary = value.as_binary();
+      std::string encoded;
+      base64::encode(binary.data(), binary.size(), encoded);
+      os << "\"\\u001Bbytes:" << encoded << "\"";
+      break;
+    }
+    case Variant::DoubleArray: {
+      std::string list;
+      const Variant::DoubleArrayType& array = value.as_double_array();
+      number::append_list(array.data(), array.size(), list);
+      os << "[" << list << "]";
+      break;
+    }
+    case Variant::FloatArray: {
+      std::string list;
+      const Variant::FloatArrayType& array = value.as_float_array();
+      number::append_list(array.data(), array.size(), list);
+      os << "[" << list << "]";
+      break;
+    }
+    case Variant::IntArray: {
+      std::string list;
+      const Variant::IntArrayType& array = value.as_int_array();
+      number::append_list(array.data(), array.size(), list);
+      os << "[" << list << "]";
+      break;
+    }
     case Variant::Map: {
       os << "{";
       bool first{true};
@@ -870,3 +1603,19 @@ std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>&
 #pragma GCC diagnostic pop
 #endif
 }
+
+namespace std
+{
+/// Computes a hash value for Variant.
+template <>
+struct hash<cisco::efm_sdk::Variant>
+{
+  /// Computes a hash value for Variant.
+  /// @param value The variant to compute the hash for.
+  /// @return The computed hash.
+  std::size_t operator()(const cisco::efm_sdk::Variant& value) const
+  {
+    return value.hash();
+  }
+};
+}
@@ -78,7 +78,7 @@ public:
   /// @param callback_on the requester event that triggers this callback
   void on_value_changed(const cisco::efm_sdk::NodePath& node_path, cisco::efm_sdk::CallbackOn callback_on)
   {
-    if (node_path == NodePath{"/str"} && callback_on == cisco::efm_sdk::CallbackOn::ValueChanged) {
+    if (node_path == EFM_NODE_PATH("/str") && callback_on == cisco::efm_sdk::CallbackOn::ValueChanged) {
       responder_.set_value(
         num_str_changes_path_,
         Variant{++num_str_changes_},
@@ -1006,9 +1006,10 @@ Our indiscretion sometimes serves us well ...
     }
 
     // these paths are the nodes actions and we don't want to add anything to it
+    const StringView name = path.name_view();
     if (
-      path.get_name() == "add_node" || path.get_name() == "remove_node" || path.get_name() == "add_attribute"
-      || path.get_name() == "remove_attribute" || path.get_name() == "metric") {
+      name == "add_node" || name == "remove_node" || name == "add_attribute" || name == "remove_attribute"
+      || name == "metric") {
       return;
     }
 
@@ -0,0 +1,1584 @@
+// @copyright_start
+// Copyright (c) 2018-2019 Cisco and/or its affiliates. All rights reserved.
+// @copyright_end
+
+/// @file efm_compact_variant.h
+
+#pragma once
+
+#include <efm_binary_buffer.h>
+#include <efm_error_code.h>
+#include <efm_exception.h>
+#include <efm_flat_map.h>
+#include <efm_variant.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace cisco
+{
+namespace efm_sdk
+{
+
+#ifdef __GNUC__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wstrict-aliasing"
+#endif
+
+/// @brief A variant sharing its value between copies.
+
+/// CompactVariant holds the same values as cisco::efm_sdk::Variant and offers the same accessors, but is 16 bytes
+/// instead of 52 bytes. Booleans and numbers are stored inline. Strings, arrays, maps, binaries and typed arrays are
+/// held in a reference counted payload behind a single pointer. Copying a CompactVariant only shares the payload, so
+/// handing one value to many consumers (e.g. the subscribers of a node) does not copy it per consumer. The hash of a
+/// payload (see CompactVariant::hash) is computed once and shared by all copies.
+///
+/// A shared array or map is cloned as soon as it is accessed through one of the mutable accessors (e.g.
+/// CompactVariant::as_array or CompactVariant::as_map). The next copy of the variant copies the value once more,
+/// so changes made through the returned reference before that copy never show up in the copy. Afterwards the value is
+/// shared again: a reference obtained before the variant was copied or moved must not be used to modify the value,
+/// call the mutable accessor again instead.
+///
+/// Maps are stored as a cisco::efm_sdk::FlatMap. The SDK library only accepts cisco::efm_sdk::Variant, a
+/// CompactVariant converts from and to it (see CompactVariant::to_variant).
+///
+/// The hashes of a CompactVariant and a cisco::efm_sdk::Variant holding the same value are the same.
+class CompactVariant
+{
+public:
+  /// Array type for Variant arrays
+  using ArrayType = std::vector<CompactVariant>;
+  /// Map type for Variant maps
+  using MapType = FlatMap<std::string, CompactVariant>;
+  /// Binary type for Variant binaries
+  using BinaryType = BinaryBuffer;
+  /// Array type for Variant double arrays
+  using DoubleArrayType = std::vector<double>;
+  /// Array type for Variant float arrays
+  using FloatArrayType = std::vector<float>;
+  /// Array type for Variant integer arrays
+  using IntArrayType = std::vector<int64_t>;
+
+  /// Specifies the type of the variant.
+  enum VariantType
+  {
+    Null,   ///< The absence of a type.
+    Bool,   ///< The variant has boolean type. The underlying type is bool.
+    Int,    ///< The variant has integer type. The underlying type is int64_t.
+    UInt,   ///< The variant has unsigned integer type. The underlying type is uint64_t.
+    Double, ///< The variant has double type. The underlying type is double.
+    String, ///< The variant has string type.
+    Map,    ///< The variant has map type.
+    Array,  ///< The variant has array type.
+    Binary,      ///< The variant has binary type. The underlying type is a cisco::efm_sdk::BinaryBuffer.
+    DoubleArray, ///< The variant has typed array type. The underlying type is std::vector<double>.
+    FloatArray,  ///< The variant has typed array type. The underlying type is std::vector<float>.
+    IntArray     ///< The variant has typed array type. The underlying type is std::vector<int64_t>.
+  };
+
+  /// Constructs an empty variant. CompactVariant::is_null will be true. The type will be CompactVariant::Null.
+  CompactVariant()
+    : type_(Null)
+  {
+  }
+
+  /// Constructs a variant of the given type. The value will be set to a default value, depending on the type:
+  /// | Variant Type | Default value |
+  /// | :----------: | :-----------: |
+  /// | Null         |       -       |
+  /// | Bool         |     false     |
+  /// | Int          |       0       |
+  /// | UInt         |       0       |
+  /// | Double       |      0.0      |
+  /// | String       |     empty     |
+  /// | Map          |       -       |
+  /// | Array        |       -       |
+  /// | Binary       |     empty     |
+  /// | DoubleArray  |     empty     |
+  /// | FloatArray   |     empty     |
+  /// | IntArray     |     empty     |
+  /// @param type The type to create a variant for.
+  CompactVariant(VariantType type)
+    : type_(type)
+  {
+    create_default(type);
+  }
+
+  /// Constructs a variant of boolean type. CompactVariant::is_null will be false. The type will be
+  /// CompactVariant::Bool. CompactVariant::as_bool will return the given value.
+  /// @tparam T The type the template is given.
+  /// @param b The bool value to set the variant to.
+  template <typename T, typename std::enable_if<std::is_same<T, bool>::value, bool>::type = 0>
+  CompactVariant(T b)
+    : type_(Bool)
+  {
+    new (raw_) bool(b);
+  }
+
+  /// Constructs a variant of unsigned integer type. CompactVariant::is_null will be false. The type will be
+  /// CompactVariant::UInt. CompactVariant::as_uint will return the given value.
+  /// @param n The unsigned integer value to set the variant to.
+  CompactVariant(uint8_t n)
+    : type_(UInt)
+  {
+    new (raw_) uint64_t(n);
+  }
+
+  /// Constructs a variant of unsigned integer type. CompactVariant::is_null will be false. The type will be
+  /// CompactVariant::UInt. CompactVariant::as_uint will return the given value.
+  /// @param n The unsigned integer value to set the variant to.
+  CompactVariant(uint16_t n)
+    : type_(UInt)
+  {
+    new (raw_) uint64_t(n);
+  }
+
+  /// Constructs a variant of unsigned integer type. CompactVariant::is_null will be false. The type will be
+  /// CompactVariant::UInt. CompactVariant::as_uint will return the given value.
+  /// @param n The unsigned integer value to set the variant to.
+  CompactVariant(uint32_t n)
+    : type_(UInt)
+  {
+    new (raw_) uint64_t(n);
+  }
+
+  /// Constructs a variant of unsigned integer type. CompactVariant::is_null will be false. The type will be
+  /// CompactVariant::UInt. CompactVariant::as_uint will return the given value.
+  /// @param n The unsigned integer value to set the variant to.
+  CompactVariant(uint64_t n)
+    : type_(UInt)
+  {
+    new (raw_) uint64_t(n);
+  }
+
+  /// Constructs a variant of integer type. CompactVariant::is_null will be false. The type will be CompactVariant::Int.
+  /// CompactVariant::as_int will return the given value.
+  /// @param n The integer value to set the variant to.
+  CompactVariant(int8_t n)
+    : type_(Int)
+  {
+    new (raw_) int64_t(n);
+  }
+
+  /// Constructs a variant of integer type. CompactVariant::is_null will be false. The type will be CompactVariant::Int.
+  /// CompactVariant::as_int will return the given value.
+  /// @param n The integer value to set the variant to.
+  CompactVariant(int16_t n)
+    : type_(Int)
+  {
+    new (raw_) int64_t(n);
+  }
+
+  /// Constructs a variant of integer type. CompactVariant::is_null will be false. The type will be CompactVariant::Int.
+  /// CompactVariant::as_int will return the given value.
+  /// @param n The integer value to set the variant to.
+  CompactVariant(int32_t n)
+    : type_(Int)
+  {
+    new (raw_) int64_t(n);
+  }
+
+  /// Constructs a variant of integer type. CompactVariant::is_null will be false. The type will be CompactVariant::Int.
+  /// CompactVariant::as_int will return the given value.
+  /// @param n The integer value to set the variant to.
+  CompactVariant(int64_t n)
+    : type_(Int)
+  {
+    new (raw_) int64_t(n);
+  }
+
+  /// Constructs a variant of double type. CompactVariant::is_null will be false. The type will be
+  /// CompactVariant::Double. CompactVariant::as_double will return the given value.
+  /// @param f The float value to set the variant to.
+  /// @throw cisco::efm_sdk::exception If value is NaN (not a number) or Infinity. Use CompactVariant::make_double to
+  /// create a variant without throwing.
+  CompactVariant(float f)
+    : type_(Double)
+  {
+    if (!std::isfinite(f)) {
+      throw exception(error_code::efm_variant_error, "not a valid float");
+    }
+    new (raw_) double(static_cast<double>(f));
+  }
+
+  /// Constructs a variant of double type. CompactVariant::is_null will be false. The type will be
+  /// CompactVariant::Double. CompactVariant::as_double will return the given value.
+  /// @param f The float value to set the variant to.
+  /// @throw cisco::efm_sdk::exception If value is NaN (not a number) or Infinity. Use CompactVariant::make_double to
+  /// create a variant without throwing.
+  CompactVariant(double f)
+    : type_(Double)
+  {
+    if (!std::isfinite(f)) {
+      throw exception(error_code::efm_variant_error, "not a valid double");
+    }
+    new (raw_) double(f);
+  }
+
+  /// Creates a variant of double type without throwing. If the value is NaN (not a number) or Infinity, a
+  /// CompactVariant::Null variant will be returned and the error code will be set.
+  /// @param f The float value to set the variant to.
+  /// @param ec Will be set to an error if the value is not finite.
+  /// @return The created variant.
+  static CompactVariant make_double(float f, std::error_code& ec)
+  {
+    return make_double(static_cast<double>(f), ec);
+  }
+
+  /// Creates a variant of double type without throwing. If the value is NaN (not a number) or Infinity, a
+  /// CompactVariant::Null variant will be returned and the error code will be set.
+  /// @param f The double value to set the variant to.
+  /// @param ec Will be set to an error if the value is not finite.
+  /// @return The created variant.
+  static CompactVariant make_double(double f, std::error_code& ec)
+  {
+    CompactVariant v;
+    if (!std::isfinite(f)) {
+      ec = make_error_code(error_code::efm_variant_error);
+      return v;
+    }
+    ec.clear();
+    v.type_ = Double;
+    new (v.raw_) double(f);
+    return v;
+  }
+
+  /// Constructs a variant of string type. CompactVariant::is_null will be false. The type will be
+  /// CompactVariant::String. CompactVariant::as_string will return the given value.
+  /// @param s The string value to set the variant to.
+  CompactVariant(const std::string& s)
+    : type_(String)
+  {
+    create_payload<std::string>(s);
+  }
+
+  /// Constructs a variant of string type. CompactVariant::is_null will be false. The type will be
+  /// CompactVariant::String. CompactVariant::as_string will return the given value.
+  /// @param s The string value to set the variant to.
+  CompactVariant(std::string&& s)
+    : type_(String)
+  {
+    create_payload<std::string>(std::move(s));
+  }
+
+  /// Constructs a variant from a char pointer.
+  ///
+  /// If the pointer is valid - CompactVariant::is_null will be false. The type will be CompactVariant::String.
+  /// CompactVariant::as_string will return the given value.
+  ///
+  /// If the pointer is null - CompactVariant::is_null will be true. The type will be CompactVariant::Null.
+  /// CompactVariant::as_string will fail.
+  //
+  /// @param s The string value to set the variant to.
+  explicit CompactVariant(const char* s)
+    : type_(Null)
+  {
+    if (s != nullptr) {
+      type_ = String;
+      create_payload<std::string>(s);
+    }
+  }
+
+  /// Constructs a variant from a char pointer.
+  ///
+  /// If the pointer is valid - CompactVariant::is_null will be false. The type will be CompactVariant::String.
+  /// CompactVariant::as_string will return the given value.
+  ///
+  /// If the pointer is null - CompactVariant::is_null will be true. The type will be CompactVariant::Null.
+  /// CompactVariant::as_string will fail.
+  //
+  /// @param s The string value to set the variant to.
+  explicit CompactVariant(char* s)
+    : type_(Null)
+  {
+    if (s != nullptr) {
+      type_ = String;
+      create_payload<std::string>(s);
+    }
+  }
+
+  /// Constructs a variant of string type. CompactVariant::is_null will be false. The type will be
+  /// CompactVariant::String. CompactVariant::as_string will return the given value.
+  /// @tparam char_count The character count of the char array.
+  /// @param s The string value to set the variant to.
+  template <size_t char_count>
+  CompactVariant(const char (&s)[char_count])
+    : type_(String)
+  {
+    create_payload<std::string>(s);
+  }
+
+  /// Constructs a variant of array type. CompactVariant::is_null will be false. The type will be CompactVariant::Array.
+  /// CompactVariant::as_array will return the given value.
+  /// @param array The array to set the variant to.
+  CompactVariant(const ArrayType& array)
+    : type_(Array)
+  {
+    create_payload<ArrayType>(array);
+  }
+
+  /// Constructs a variant of array type. CompactVariant::is_null will be false. The type will be CompactVariant::Array.
+  /// CompactVariant::as_array will return the given value.
+  /// @param array The array to set the variant to.
+  CompactVariant(ArrayType&& array)
+    : type_(Array)
+  {
+    create_payload<ArrayType>(std::move(array));
+  }
+
+  /// Constructs a variant of map type. CompactVariant::is_null will be false. The type will be CompactVariant::Map.
+  /// CompactVariant::as_map will return the given value.
+  /// @param map The map to set the variant to.
+  CompactVariant(const MapType& map)
+    : type_(Map)
+  {
+    create_payload<MapType>(map);
+  }
+
+  /// Constructs a variant of map type. CompactVariant::is_null will be false. The type will be CompactVariant::Map.
+  /// CompactVariant::as_map will return the given value.
+  /// @param map The map to set the variant to.
+  CompactVariant(MapType&& map)
+    : type_(Map)
+  {
+    create_payload<MapType>(std::move(map));
+  }
+
+  /// Constructs a variant of binary type. CompactVariant::is_null will be false. The type will be
+  /// CompactVariant::Binary. CompactVariant::as_binary will return the given value. The bytes of the buffer are not
+  /// copied.
+  ///
+  /// Binaries are supported by cisco::efm_sdk::json::Writer, which writes them as DSA binary string, and by
+  /// cisco::efm_sdk::msgpack::encode. Values handed to the SDK library (e.g. cisco::efm_sdk::Responder::set_value or
+  /// cisco::efm_sdk::json::to_json_string) have to be encoded as DSA binary string first, see
+  /// cisco::efm_sdk::encode_dsa_binary.
+  /// @param binary The binary to set the variant to.
+  CompactVariant(const BinaryType& binary)
+    : type_(Binary)
+  {
+    create_payload<BinaryType>(binary);
+  }
+
+  /// Constructs a variant of binary type. CompactVariant::is_null will be false. The type will be
+  /// CompactVariant::Binary. CompactVariant::as_binary will return the given value. The bytes of the buffer are not
+  /// copied.
+  ///
+  /// Binaries are supported by cisco::efm_sdk::json::Writer, which writes them as DSA binary string, and by
+  /// cisco::efm_sdk::msgpack::encode. Values handed to the SDK library (e.g. cisco::efm_sdk::Responder::set_value or
+  /// cisco::efm_sdk::json::to_json_string) have to be encoded as DSA binary string first, see
+  /// cisco::efm_sdk::encode_dsa_binary.
+  /// @param binary The binary to set the variant to.
+  CompactVariant(BinaryType&& binary)
+    : type_(Binary)
+  {
+    create_payload<BinaryType>(std::move(binary));
+  }
+
+  /// Constructs a variant of typed array type. CompactVariant::is_null will be false. The type will be
+  /// CompactVariant::DoubleArray. CompactVariant::as_double_array will return the given values.
+  /// @param array The values to set the variant to.
+  /// @throw cisco::efm_sdk::exception If one of the values is NaN (not a number) or Infinity. Use
+  /// CompactVariant::make_double_array to create a variant without throwing.
+  CompactVariant(const DoubleArrayType& array)
+    : type_(DoubleArray)
+  {
+    check_finite(array);
+    create_payload<TypedArray<double>>(array);
+  }
+
+  /// Constructs a variant of typed array type. CompactVariant::is_null will be false. The type will be
+  /// CompactVariant::DoubleArray. CompactVariant::as_double_array will return the given values.
+  /// @param array The values to set the variant to.
+  /// @throw cisco::efm_sdk::exception If one of the values is NaN (not a number) or Infinity. Use
+  /// CompactVariant::make_double_array to create a variant without throwing.
+  CompactVariant(DoubleArrayType&& array)
+    : type_(DoubleArray)
+  {
+    check_finite(array);
+    create_payload<TypedArray<double>>(std::move(array));
+  }
+
+  /// Constructs a variant of typed array type. CompactVariant::is_null will be false. The type will be
+  /// CompactVariant::FloatArray. CompactVariant::as_float_array will return the given values.
+  /// @param array The values to set the variant to.
+  /// @throw cisco::efm_sdk::exception If one of the values is NaN (not a number) or Infinity. Use
+  /// CompactVariant::make_float_array to create a variant without throwing.
+  CompactVariant(const FloatArrayType& array)
+    : type_(FloatArray)
+  {
+    check_finite(array);
+    create_payload<TypedArray<float>>(array);
+  }
+
+  /// Constructs a variant of typed array type. CompactVariant::is_null will be false. The type will be
+  /// CompactVariant::FloatArray. CompactVariant::as_float_array will return the given values.
+  /// @param array The values to set the variant to.
+  /// @throw cisco::efm_sdk::exception If one of the values is NaN (not a number) or Infinity. Use
+  /// CompactVariant::make_float_array to create a variant without throwing.
+  CompactVariant(FloatArrayType&& array)
+    : type_(FloatArray)
+  {
+    check_finite(array);
+    create_payload<TypedArray<float>>(std::move(array));
+  }
+
+  /// Creates a variant of typed array type CompactVariant::DoubleArray without throwing on invalid values. If one of
+  /// the values is NaN (not a number) or Infinity, a CompactVariant::Null variant will be returned and the error code
+  /// will be set.
+  /// @param array The values to set the variant to.
+  /// @param ec Will be set to an error if one of the values is not finite.
+  /// @return The created variant.
+  static CompactVariant make_double_array(DoubleArrayType array, std::error_code& ec)
+  {
+    return make_typed_array(std::move(array), DoubleArray, ec);
+  }
+
+  /// Creates a variant of typed array type CompactVariant::FloatArray without throwing on invalid values. If one of the
+  /// values is NaN (not a number) or Infinity, a CompactVariant::Null variant will be returned and the error code will
+  /// be set.
+  /// @param array The values to set the variant to.
+  /// @param ec Will be set to an error if one of the values is not finite.
+  /// @return The created variant.
+  static CompactVariant make_float_array(FloatArrayType array, std::error_code& ec)
+  {
+    return make_typed_array(std::move(array), FloatArray, ec);
+  }
+
+  /// Constructs a variant of typed array type. CompactVariant::is_null will be false. The type will be
+  /// CompactVariant::IntArray. CompactVariant::as_int_array will return the given values.
+  /// @param array The values to set the variant to.
+  CompactVariant(const IntArrayType& array)
+    : type_(IntArray)
+  {
+    create_payload<TypedArray<int64_t>>(array);
+  }
+
+  /// Constructs a variant of typed array type. CompactVariant::is_null will be false. The type will be
+  /// CompactVariant::IntArray. CompactVariant::as_int_array will return the given values.
+  /// @param array The values to set the variant to.
+  CompactVariant(IntArrayType&& array)
+    : type_(IntArray)
+  {
+    create_payload<TypedArray<int64_t>>(std::move(array));
+  }
+
+  /// Constructs a variant holding the value of the given cisco::efm_sdk::Variant.
+  /// @param value The variant to convert.
+  explicit CompactVariant(const Variant& value)
+    : type_(Null)
+  {
+    assign(value);
+  }
+
+  /// Converts the variant into a cisco::efm_sdk::Variant, e.g. to hand it to the SDK library.
+  /// @return The converted variant.
+  Variant to_variant() const
+  {
+    switch (type_) {
+      case Null:
+        break;
+      case Bool:
+        return Variant(*reinterpret_cast<const bool*>(raw_));
+      case Int:
+        return Variant(*reinterpret_cast<const int64_t*>(raw_));
+      case UInt:
+        return Variant(*reinterpret_cast<const uint64_t*>(raw_));
+      case Double:
+        return Variant(*reinterpret_cast<const double*>(raw_));
+      case String:
+        return Variant(payload<std::string>()->value_);
+      case Array: {
+        Variant::ArrayType array;
+        array.reserve(payload<ArrayType>()->value_.size());
+        for (const auto& element : payload<ArrayType>()->value_) {
+          array.push_back(element.to_variant());
+        }
+        return Variant(std::move(array));
+      }
+      case Map: {
+        Variant::MapType map;
+        for (const auto& element : payload<MapType>()->value_) {
+          // the elements are sorted, inserting them at the end is constant per element
+          map.emplace_hint(map.end(), element.first, element.second.to_variant());
+        }
+        return Variant(std::move(map));
+      }
+      case Binary:
+        return Variant(payload<BinaryType>()->value_);
+      case DoubleArray:
+        return Variant(payload<TypedArray<double>>()->value_.values_);
+      case FloatArray:
+        return Variant(payload<TypedArray<float>>()->value_.values_);
+      case IntArray:
+        return Variant(payload<TypedArray<int64_t>>()->value_.values_);
+    }
+    return Variant();
+  }
+
+  /// Destroys the variant
+  ~CompactVariant()
+  {
+    destroy();
+  }
+
+  /// Constructs a variant from another variant, moving its internal representation.
+  /// @param other Variant to move into this variant.
+  CompactVariant(CompactVariant&& other) noexcept
+    : type_(other.type_)
+  {
+    other.type_ = Null;
+    std::copy(other.raw_, other.raw_ + sizeof(raw_), raw_);
+  }
+
+  /// Constructs a variant from another variant. The value is not copied, but shared with the other variant. An array
+  /// or map accessed through a mutable accessor of the other variant since its last copy is copied.
+  /// @param other The variant to use to initialize this variant.
+  CompactVariant(const CompactVariant& other)
+    : type_(other.type_)
+  {
+    std::copy(other.raw_, other.raw_ + sizeof(raw_), raw_);
+    acquire();
+  }
+
+  /// Assigns the given variant to this one. The value is not copied, but shared with the other variant. An array or
+  /// map accessed through a mutable accessor of the other variant since its last copy is copied.
+  /// @param other The variant to assign to this one.
+  /// @return A reference to this variant.
+  CompactVariant& operator=(const CompactVariant& other)
+  {
+    if (this == &other) {
+      return *this;
+    }
+
+    return *this = CompactVariant(other);
+  }
+
+  /// Assigns the given moved variant to this one.
+  /// @param other The moved variant to assign to this one.
+  /// @return A reference to this variant.
+  CompactVariant& operator=(CompactVariant&& other) noexcept
+  {
+    if (this == &other) {
+      return *this;
+    }
+
+    destroy();
+    type_ = other.type_;
+    other.type_ = Null;
+    std::copy(other.raw_, other.raw_ + sizeof(raw_), raw_);
+    return *this;
+  }
+
+  /// Compare this variant to another one for equality. Variants sharing the same payload are equal without comparing
+  /// their values. Variants with different cached hashes (see CompactVariant::hash) are unequal without comparing their
+  /// values.
+  /// @param other The variant to compare to this one.
+  /// @return true if both variants are identical, false otherwise.
+  bool operator==(const CompactVariant& other) const
+  {
+    return equals(other);
+  }
+
+  /// Compare this variant to another one for inequality.
+  /// @param other The variant to compare to this one.
+  /// @return true if both variants are not identical, false otherwise.
+  bool operator!=(const CompactVariant& other) const
+  {
+    return !equals(other);
+  }
+
+  /// Computes a structural hash of the variant. Variants comparing equal have the same hash, e.g. an integer and an
+  /// unsigned integer of the same value or a typed array and a generic array with the same elements.
+  ///
+  /// The hash of strings, arrays, maps, binaries and typed arrays is computed once and cached in their payload, so
+  /// it is shared by all copies of the variant. The hash of an array or map that may still be modified through a
+  /// reference returned by one of the mutable accessors (e.g. CompactVariant::as_map) is not cached, neither is the
+  /// hash of an array or map containing such a value.
+  /// @return The hash of the variant.
+  std::size_t hash() const
+  {
+    bool cacheable = true;
+    return hash(cacheable);
+  }
+
+  /// Computes a hash value for a variant, see CompactVariant::hash.
+  struct Hash
+  {
+    /// Computes a hash value for a variant.
+    /// @param value The variant to compute the hash for.
+    /// @return The computed hash.
+    std::size_t operator()(const CompactVariant& value) const
+    {
+      return value.hash();
+    }
+  };
+
+  /// Checks if the variant is of null type.
+  /// @return true if it is of null type, otherwise false.
+  bool is_null() const
+  {
+    return type_ == Null;
+  }
+
+  /// Returns the CompactVariant::VariantType of this variant.
+  /// @return The type of this variant.
+  VariantType type() const
+  {
+    return type_;
+  }
+
+  /// Returns the boolean value of the variant if the variants type is CompactVariant::Bool.
+  /// @exception If the type is not CompactVariant::Bool.
+  /// @return The boolean value of the variant.
+  bool as_bool() const
+  {
+    if (type_ != Bool) {
+      throw exception(error_code::efm_variant_error, "not a bool");
+    }
+    return *reinterpret_cast<const bool*>(raw_);
+  }
+
+  /// Returns the integer value of the variant if the variants type is CompactVariant::Int.
+  /// @exception If the type is not CompactVariant::Int.
+  /// @return The integer value of the variant.
+  int64_t as_int() const
+  {
+    if (type_ != Int && type_ != UInt) {
+      throw exception(error_code::efm_variant_error, "not an int");
+    }
+    return *reinterpret_cast<const int64_t*>(raw_);
+  }
+
+  /// Returns the unsigned integer value of the variant if the variants type is CompactVariant::UInt.
+  /// @exception If the type is not CompactVariant::UInt.
+  /// @return The unsigned integer value of the variant.
+  uint64_t as_uint() const
+  {
+    if (type_ != UInt && type_ != Int) {
+      throw exception(error_code::efm_variant_error, "not an uint");
+    }
+    return *reinterpret_cast<const uint64_t*>(raw_);
+  }
+
+  /// Returns the double value of the variant if the variants type is CompactVariant::Double.
+  /// @exception If the type is not CompactVariant::Double.
+  /// @return The double value of the variant.
+  double as_double() const
+  {
+    if (type_ != Double) {
+      throw exception(error_code::efm_variant_error, "not a double");
+    }
+    return *reinterpret_cast<const double*>(raw_);
+  }
+
+  /// Returns the string value of the variant if the variants type is CompactVariant::String.
+  /// @exception If the type is not CompactVariant::String.
+  /// @return The string value of the variant.
+  const std::string& as_string() const
+  {
+    if (type_ != String) {
+      throw exception(error_code::efm_variant_error, "not a string");
+    }
+    return payload<std::string>()->value_;
+  }
+
+  /// Returns a non-mutable array of variants if the variants type is CompactVariant::Array or one of the typed array
+  /// types. A typed array is converted to a generic array on the first call, the conversion is kept as long as the
+  /// typed array exists.
+  /// @exception If the type is not CompactVariant::Array or a typed array.
+  /// @return An array of variants.
+  const ArrayType& as_array() const
+  {
+    switch (type_) {
+      case Array:
+        return payload<ArrayType>()->value_;
+      case DoubleArray:
+        return payload<TypedArray<double>>()->value_.generic();
+      case FloatArray:
+        return payload<TypedArray<float>>()->value_.generic();
+      case IntArray:
+        return payload<TypedArray<int64_t>>()->value_.generic();
+      default:
+        throw exception(error_code::efm_variant_error, "not an array");
+    }
+  }
+
+  /// Returns a non-mutable map of variants if the variants type is CompactVariant::Map.
+  /// @exception If the type is not CompactVariant::Map.
+  /// @return An map of variants.
+  const MapType& as_map() const
+  {
+    if (type_ != Map) {
+      throw exception(error_code::efm_variant_error, "not a map");
+    }
+    return payload<MapType>()->value_;
+  }
+
+  /// Returns the binary value of the variant if the variants type is CompactVariant::Binary. Binaries are immutable.
+  /// @exception If the type is not CompactVariant::Binary.
+  /// @return The binary value of the variant.
+  const BinaryType& as_binary() const
+  {
+    if (type_ != Binary) {
+      throw exception(error_code::efm_variant_error, "not a binary");
+    }
+    return payload<BinaryType>()->value_;
+  }
+
+  /// Returns the values of the variant if the variants type is CompactVariant::DoubleArray. Typed arrays are immutable.
+  /// @exception If the type is not CompactVariant::DoubleArray.
+  /// @return The values of the variant.
+  const DoubleArrayType& as_double_array() const
+  {
+    if (type_ != DoubleArray) {
+      throw exception(error_code::efm_variant_error, "not a double array");
+    }
+    return payload<TypedArray<double>>()->value_.values_;
+  }
+
+  /// Returns the values of the variant if the variants type is CompactVariant::FloatArray. Typed arrays are immutable.
+  /// @exception If the type is not CompactVariant::FloatArray.
+  /// @return The values of the variant.
+  const FloatArrayType& as_float_array() const
+  {
+    if (type_ != FloatArray) {
+      throw exception(error_code::efm_variant_error, "not a float array");
+    }
+    return payload<TypedArray<float>>()->value_.values_;
+  }
+
+  /// Returns the values of the variant if the variants type is CompactVariant::IntArray. Typed arrays are immutable.
+  /// @exception If the type is not CompactVariant::IntArray.
+  /// @return The values of the variant.
+  const IntArrayType& as_int_array() const
+  {
+    if (type_ != IntArray) {
+      throw exception(error_code::efm_variant_error, "not an int array");
+    }
+    return payload<TypedArray<int64_t>>()->value_.values_;
+  }
+
+  /// Returns a mutable array of variants if the variants type is CompactVariant::Array. If the array is shared with
+  /// other variants, it will be cloned first. The next copy of this variant copies the array instead of sharing it.
+  /// A typed array is converted to a generic array and the type of the variant changes to CompactVariant::Array.
+  /// @exception If the type is not CompactVariant::Array or a typed array.
+  /// @return An array of variants.
+  ArrayType& as_array()
+  {
+    switch (type_) {
+      case Array:
+        return detach<ArrayType>();
+      case DoubleArray:
+        return convert_to_array<double>();
+      case FloatArray:
+        return convert_to_array<float>();
+      case IntArray:
+        return convert_to_array<int64_t>();
+      default:
+        throw exception(error_code::efm_variant_error, "not an array");
+    }
+  }
+
+  /// Returns a mutable map of variants if the variants type is CompactVariant::Map. If the map is shared with other
+  /// variants, it will be cloned first. The next copy of this variant copies the map instead of sharing it.
+  /// @exception If the type is not CompactVariant::Map.
+  /// @return An map of variants.
+  MapType& as_map()
+  {
+    if (type_ != Map) {
+      throw exception(error_code::efm_variant_error, "not a map");
+    }
+    return detach<MapType>();
+  }
+
+  /// Retrieves the boolean value of the variant without throwing.
+  /// @param value Will be set to the value if the variants type is CompactVariant::Bool.
+  /// @return true if the variants type is CompactVariant::Bool, otherwise false.
+  bool try_as_bool(bool& value) const noexcept
+  {
+    if (type_ != Bool) {
+      return false;
+    }
+    value = *reinterpret_cast<const bool*>(raw_);
+    return true;
+  }
+
+  /// Retrieves the integer value of the variant without throwing.
+  /// @param value Will be set to the value if the variants type is CompactVariant::Int or CompactVariant::UInt.
+  /// @return true if the variants type is CompactVariant::Int or CompactVariant::UInt, otherwise false.
+  bool try_as_int(int64_t& value) const noexcept
+  {
+    if (type_ != Int && type_ != UInt) {
+      return false;
+    }
+    value = *reinterpret_cast<const int64_t*>(raw_);
+    return true;
+  }
+
+  /// Retrieves the unsigned integer value of the variant without throwing.
+  /// @param value Will be set to the value if the variants type is CompactVariant::UInt or CompactVariant::Int.
+  /// @return true if the variants type is CompactVariant::UInt or CompactVariant::Int, otherwise false.
+  bool try_as_uint(uint64_t& value) const noexcept
+  {
+    if (type_ != UInt && type_ != Int) {
+      return false;
+    }
+    value = *reinterpret_cast<const uint64_t*>(raw_);
+    return true;
+  }
+
+  /// Retrieves the double value of the variant without throwing.
+  /// @param value Will be set to the value if the variants type is CompactVariant::Double.
+  /// @return true if the variants type is CompactVariant::Double, otherwise false.
+  bool try_as_double(double& value) const noexcept
+  {
+    if (type_ != Double) {
+      return false;
+    }
+    value = *reinterpret_cast<const double*>(raw_);
+    return true;
+  }
+
+  /// Returns the string value of the variant without throwing.
+  /// @return A pointer to the string if the variants type is CompactVariant::String, otherwise a nullptr.
+  const std::string* get_if_string() const noexcept
+  {
+    return type_ == String ? &payload<std::string>()->value_ : nullptr;
+  }
+
+  /// Returns a non-mutable array of variants without throwing if the variant is not an array. A typed array is
+  /// converted like in CompactVariant::as_array, the conversion allocates and may throw std::bad_alloc.
+  /// @return A pointer to the array if the variants type is CompactVariant::Array or a typed array, otherwise a
+  /// nullptr.
+  const ArrayType* get_if_array() const
+  {
+    return is_array() ? &as_array() : nullptr;
+  }
+
+  /// Returns a non-mutable map of variants without throwing.
+  /// @return A pointer to the map if the variants type is CompactVariant::Map, otherwise a nullptr.
+  const MapType* get_if_map() const noexcept
+  {
+    return type_ == Map ? &payload<MapType>()->value_ : nullptr;
+  }
+
+  /// Returns the binary value of the variant without throwing.
+  /// @return A pointer to the binary if the variants type is CompactVariant::Binary, otherwise a nullptr.
+  const BinaryType* get_if_binary() const noexcept
+  {
+    return type_ == Binary ? &payload<BinaryType>()->value_ : nullptr;
+  }
+
+  /// Returns the values of a typed array without throwing.
+  /// @return A pointer to the values if the variants type is CompactVariant::DoubleArray, otherwise a nullptr.
+  const DoubleArrayType* get_if_double_array() const noexcept
+  {
+    return type_ == DoubleArray ? &payload<TypedArray<double>>()->value_.values_ : nullptr;
+  }
+
+  /// Returns the values of a typed array without throwing.
+  /// @return A pointer to the values if the variants type is CompactVariant::FloatArray, otherwise a nullptr.
+  const FloatArrayType* get_if_float_array() const noexcept
+  {
+    return type_ == FloatArray ? &payload<TypedArray<float>>()->value_.values_ : nullptr;
+  }
+
+  /// Returns the values of a typed array without throwing.
+  /// @return A pointer to the values if the variants type is CompactVariant::IntArray, otherwise a nullptr.
+  const IntArrayType* get_if_int_array() const noexcept
+  {
+    return type_ == IntArray ? &payload<TypedArray<int64_t>>()->value_.values_ : nullptr;
+  }
+
+  /// Checks if the variant is an array, either a generic or a typed one.
+  /// @return true if the variants type is CompactVariant::Array or one of the typed array types, otherwise false.
+  bool is_array() const noexcept
+  {
+    return type_ == Array || type_ == DoubleArray || type_ == FloatArray || type_ == IntArray;
+  }
+
+  /// Calls the visitor with the value of the variant. The dispatch is a plain switch over the type of the variant,
+  /// no virtual calls are involved. The visitor has to be callable with each of the following argument types and
+  /// return the same type for all of them:
+  /// | Variant Type | Argument type          |
+  /// | :----------: | :--------------------: |
+  /// | Null         | std::nullptr_t         |
+  /// | Bool         | bool                   |
+  /// | Int          | int64_t                |
+  /// | UInt         | uint64_t               |
+  /// | Double       | double                 |
+  /// | String       | const std::string&     |
+  /// | Map          | const MapType&         |
+  /// | Array        | const ArrayType&       |
+  /// | Binary       | const BinaryType&      |
+  /// | DoubleArray  | const DoubleArrayType& |
+  /// | FloatArray   | const FloatArrayType&  |
+  /// | IntArray     | const IntArrayType&    |
+  ///
+  /// Typed arrays are handed over as they are, so a visitor can process the contiguous values directly.
+  /// @tparam Visitor The type of the visitor.
+  /// @param visitor The visitor to call.
+  /// @return The result of the visitor call.
+  template <typename Visitor>
+  auto visit(Visitor&& visitor) const -> decltype(std::forward<Visitor>(visitor)(nullptr))
+  {
+    switch (type_) {
+      case Null:
+        break;
+      case Bool:
+        return std::forward<Visitor>(visitor)(*reinterpret_cast<const bool*>(raw_));
+      case Int:
+        return std::forward<Visitor>(visitor)(*reinterpret_cast<const int64_t*>(raw_));
+      case UInt:
+        return std::forward<Visitor>(visitor)(*reinterpret_cast<const uint64_t*>(raw_));
+      case Double:
+        return std::forward<Visitor>(visitor)(*reinterpret_cast<const double*>(raw_));
+      case String:
+        return std::forward<Visitor>(visitor)(payload<std::string>()->value_);
+      case Array:
+        return std::forward<Visitor>(visitor)(payload<ArrayType>()->value_);
+      case Map:
+        return std::forward<Visitor>(visitor)(payload<MapType>()->value_);
+      case Binary:
+        return std::forward<Visitor>(visitor)(payload<BinaryType>()->value_);
+      case DoubleArray:
+        return std::forward<Visitor>(visitor)(payload<TypedArray<double>>()->value_.values_);
+      case FloatArray:
+        return std::forward<Visitor>(visitor)(payload<TypedArray<float>>()->value_.values_);
+      case IntArray:
+        return std::forward<Visitor>(visitor)(payload<TypedArray<int64_t>>()->value_.values_);
+    }
+    return std::forward<Visitor>(visitor)(nullptr);
+  }
+
+  /// Retrieves a mutable element at the given array index position if the variants type is CompactVariant::Array.
+  /// @exception If the type is not CompactVariant::Array.
+  /// @exception If the index is out of range.
+  /// @param i The index of the element to retrieve.
+  /// @return The element at the given index.
+  CompactVariant& get(typename ArrayType::size_type i)
+  {
+    ArrayType& arr = as_array();
+    if (i >= arr.size()) {
+      throw exception(error_code::efm_variant_error, "index out of bounds");
+    }
+    return arr[i];
+  }
+
+  /// Retrieves an non-mutable element at the given array index position if the variants type is CompactVariant::Array.
+  /// @exception If the type is not CompactVariant::Array.
+  /// @exception If the index is out of range.
+  /// @param i The index of the element to retrieve.
+  /// @return The element at the given index.
+  const CompactVariant& get(typename ArrayType::size_type i) const
+  {
+    const ArrayType& arr = as_array();
+    if (i >= arr.size()) {
+      throw exception(error_code::efm_variant_error, "index out of bounds");
+    }
+    return arr[i];
+  }
+
+  /// Retrieves a mutable element at the given array index position if the variants type is CompactVariant::Array.
+  /// @exception If the type is not CompactVariant::Array.
+  /// @exception If the index is out of range.
+  /// @param i The index of the element to retrieve.
+  /// @return The element at the given index.
+  CompactVariant& operator[](typename ArrayType::size_type i)
+  {
+    return get(i);
+  }
+
+  /// Retrieves an non-mutable element at the given array index position if the variants type is CompactVariant::Array.
+  /// @exception If the type is not CompactVariant::Array.
+  /// @exception If the index is out of range.
+  /// @param i The index of the element to retrieve.
+  /// @return The element at the given index.
+  const CompactVariant& operator[](typename ArrayType::size_type i) const
+  {
+    return get(i);
+  }
+
+  /// Retrieves a mutable element for the given key from a variant map, if the variants type is CompactVariant::Map.
+  /// @exception If the type is not CompactVariant::Map.
+  /// @param key The key of the element to retrieve.
+  /// @return The element for the key or a nullptr.
+  CompactVariant* get(const std::string& key)
+  {
+    MapType& m = as_map();
+    auto it = m.find(key);
+    if (it == m.end()) {
+      return nullptr;
+    }
+    return &it->second;
+  }
+
+  /// Retrieves a non-mutable element for the given key from a variant map, if the variants type is CompactVariant::Map.
+  /// @exception If the type is not CompactVariant::Map.
+  /// @param key The key of the element to retrieve.
+  /// @return The element for the key or a nullptr.
+  const CompactVariant* get(const std::string& key) const
+  {
+    const MapType& m = as_map();
+    const auto it = m.find(key);
+    if (it == m.end()) {
+      return nullptr;
+    }
+    return &it->second;
+  }
+
+  /// Retrieves a mutable element for the given key from a variant map, if the variants type is CompactVariant::Map.
+  /// @exception If the type is not CompactVariant::Map.
+  /// @param key The key of the element to retrieve.
+  /// @return The element for the key.
+  /// @throw cisco::efm_sdk::exception If the key does not exist.
+  CompactVariant& operator[](const std::string& key)
+  {
+    auto* v = get(key);
+    if (v == nullptr) {
+      throw exception(error_code::efm_variant_error, "key not found");
+    }
+    return *v;
+  }
+
+  /// Retrieves a non-mutable element for the given key from a variant map, if the variants type is CompactVariant::Map.
+  /// @exception If the type is not CompactVariant::Map.
+  /// @param key The key of the element to retrieve.
+  /// @return The element for the key.
+  /// @throw cisco::efm_sdk::exception If the key does not exist.
+  const CompactVariant& operator[](const std::string& key) const
+  {
+    const auto* v = get(key);
+    if (v == nullptr) {
+      throw exception(error_code::efm_variant_error, "key not found");
+    }
+    return *v;
+  }
+
+private:
+  /// @private
+  /// The reference counted payload of strings, arrays, maps, binaries and typed arrays.
+  template <typename T>
+  struct Payload
+  {
+    template <typename... Args>
+    explicit Payload(Args&&... args)
+      : value_(std::forward<Args>(args)...)
+    {
+    }
+
+    std::atomic<uint32_t> refs_{1};
+    // true while a reference handed out by a mutable accessor may modify the value, the next copy copies the value
+    std::atomic<bool> exposed_{false};
+    mutable std::atomic<std::size_t> hash_{0}; // 0 if not computed yet
+    T value_;
+  };
+
+  /// @private
+  /// The values of a typed array together with the generic array created from them on demand.
+  template <typename T>
+  struct TypedArray
+  {
+    explicit TypedArray(const std::vector<T>& values)
+      : values_(values)
+    {
+    }
+
+    explicit TypedArray(std::vector<T>&& values)
+      : values_(std::move(values))
+    {
+    }
+
+    ~TypedArray()
+    {
+      delete generic_.load(std::memory_order_acquire);
+    }
+
+    const ArrayType& generic() const
+    {
+      ArrayType* array = generic_.load(std::memory_order_acquire);
+      if (array == nullptr) {
+        ArrayType* created = new ArrayType(values_.begin(), values_.end());
+        // the payload may be shared between threads, the first conversion wins
+        if (generic_.compare_exchange_strong(array, created, std::memory_order_acq_rel)) {
+          array = created;
+        } else {
+          delete created;
+        }
+      }
+      return *array;
+    }
+
+    bool operator==(const TypedArray& other) const
+    {
+      return values_ == other.values_;
+    }
+
+    std::vector<T> values_;
+    mutable std::atomic<ArrayType*> generic_{nullptr};
+  };
+
+  inline void create_default(VariantType type)
+  {
+    switch (type) {
+      case Null:
+        break;
+      case Bool:
+        new (raw_) bool(false);
+        break;
+      case Int:
+        new (raw_) int64_t(0);
+        break;
+      case UInt:
+        new (raw_) uint64_t(0);
+        break;
+      case Double:
+        new (raw_) double(0.0);
+        break;
+      case String:
+        create_payload<std::string>();
+        break;
+      case Map:
+        create_payload<MapType>();
+        break;
+      case Array:
+        create_payload<ArrayType>();
+        break;
+      case Binary:
+        create_payload<BinaryType>();
+        break;
+      case DoubleArray:
+        create_payload<TypedArray<double>>(DoubleArrayType());
+        break;
+      case FloatArray:
+        create_payload<TypedArray<float>>(FloatArrayType());
+        break;
+      case IntArray:
+        create_payload<TypedArray<int64_t>>(IntArrayType());
+        break;
+    }
+  }
+
+  // expects this variant to be of null type
+  void assign(const Variant& value)
+  {
+    static_assert(static_cast<int>(Variant::IntArray) == static_cast<int>(IntArray), "the types have to match");
+
+    switch (value.type()) {
+      case Variant::Null:
+        break;
+      case Variant::Bool:
+        new (raw_) bool(value.as_bool());
+        break;
+      case Variant::Int:
+        new (raw_) int64_t(value.as_int());
+        break;
+      case Variant::UInt:
+        new (raw_) uint64_t(value.as_uint());
+        break;
+      case Variant::Double:
+        new (raw_) double(value.as_double());
+        break;
+      case Variant::String:
+        create_payload<std::string>(value.as_string());
+        break;
+      case Variant::Array: {
+        ArrayType array;
+        array.reserve(value.as_array().size());
+        for (const auto& element : value.as_array()) {
+          array.emplace_back(element);
+        }
+        create_payload<ArrayType>(std::move(array));
+        break;
+      }
+      case Variant::Map: {
+        std::vector<std::pair<std::string, CompactVariant>> elements;
+        elements.reserve(value.as_map().size());
+        for (const auto& element : value.as_map()) {
+          elements.emplace_back(element.first, CompactVariant(element.second));
+        }
+        // the elements of a std::map are sorted already
+        create_payload<MapType>(std::make_move_iterator(elements.begin()), std::make_move_iterator(elements.end()));
+        break;
+      }
+      case Variant::Binary:
+        create_payload<BinaryType>(value.as_binary());
+        break;
+      case Variant::DoubleArray:
+        create_payload<TypedArray<double>>(value.as_double_array());
+        break;
+      case Variant::FloatArray:
+        create_payload<TypedArray<float>>(value.as_float_array());
+        break;
+      case Variant::IntArray:
+        create_payload<TypedArray<int64_t>>(value.as_int_array());
+        break;
+    }
+    type_ = static_cast<VariantType>(value.type());
+  }
+
+  void destroy()
+  {
+    switch (type_) {
+      case Null:
+      case Bool:
+      case Int:
+      case UInt:
+      case Double:
+        // do nothing
+        break;
+      case String:
+        release<std::string>();
+        break;
+      case Array:
+        release<ArrayType>();
+        break;
+      case Map:
+        release<MapType>();
+        break;
+      case Binary:
+        release<BinaryType>();
+        break;
+      case DoubleArray:
+        release<TypedArray<double>>();
+        break;
+      case FloatArray:
+        release<TypedArray<float>>();
+        break;
+      case IntArray:
+        release<TypedArray<int64_t>>();
+        break;
+    }
+  }
+
+  // shares the payload copied from another variant, or copies an exposed array or map
+  void acquire()
+  {
+    switch (type_) {
+      case Null:
+      case Bool:
+      case Int:
+      case UInt:
+      case Double:
+        // do nothing
+        break;
+      case String:
+        payload<std::string>()->refs_.fetch_add(1, std::memory_order_relaxed);
+        break;
+      case Array:
+        share<ArrayType>();
+        break;
+      case Map:
+        share<MapType>();
+        break;
+      case Binary:
+        payload<BinaryType>()->refs_.fetch_add(1, std::memory_order_relaxed);
+        break;
+      case DoubleArray:
+        payload<TypedArray<double>>()->refs_.fetch_add(1, std::memory_order_relaxed);
+        break;
+      case FloatArray:
+        payload<TypedArray<float>>()->refs_.fetch_add(1, std::memory_order_relaxed);
+        break;
+      case IntArray:
+        payload<TypedArray<int64_t>>()->refs_.fetch_add(1, std::memory_order_relaxed);
+        break;
+    }
+  }
+
+  template <typename T, typename... Args>
+  void create_payload(Args&&... args)
+  {
+    new (raw_) Payload<T>*(new Payload<T>(std::forward<Args>(args)...));
+  }
+
+  template <typename T>
+  Payload<T>* payload() const
+  {
+    return *reinterpret_cast<Payload<T>* const*>(raw_);
+  }
+
+  template <typename T>
+  void share()
+  {
+    Payload<T>* p = payload<T>();
+    if (p->exposed_.exchange(false, std::memory_order_relaxed)) {
+      // the value may have been modified through a reference since the last copy, this copy gets its own value and
+      // later copies share it again
+      create_payload<T>(p->value_);
+    } else {
+      p->refs_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  template <typename T>
+  void release()
+  {
+    Payload<T>* p = payload<T>();
+    if (p->refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      delete p;
+    }
+  }
+
+  template <typename T>
+  T& detach()
+  {
+    Payload<T>* p = payload<T>();
+    if (p->refs_.load(std::memory_order_acquire) != 1) {
+      Payload<T>* copy = new Payload<T>(p->value_);
+      release<T>();
+      new (raw_) Payload<T>*(copy);
+      p = copy;
+    }
+    p->exposed_.store(true, std::memory_order_relaxed);
+    p->hash_.store(0, std::memory_order_relaxed);
+    return p->value_;
+  }
+
+  template <typename T>
+  ArrayType& convert_to_array()
+  {
+    Payload<ArrayType>* array = new Payload<ArrayType>(payload<TypedArray<T>>()->value_.generic());
+    array->exposed_.store(true, std::memory_order_relaxed);
+    release<TypedArray<T>>();
+    type_ = Array;
+    new (raw_) Payload<ArrayType>*(array);
+    return array->value_;
+  }
+
+  template <typename T>
+  static bool all_finite(const std::vector<T>& values)
+  {
+    for (T value : values) {
+      if (!std::isfinite(value)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  template <typename T>
+  static void check_finite(const std::vector<T>& values)
+  {
+    if (!all_finite(values)) {
+      throw exception(error_code::efm_variant_error, "not a valid number array");
+    }
+  }
+
+  template <typename T>
+  static CompactVariant make_typed_array(std::vector<T>&& values, VariantType type, std::error_code& ec)
+  {
+    CompactVariant v;
+    if (!all_finite(values)) {
+      ec = make_error_code(error_code::efm_variant_error);
+      return v;
+    }
+    ec.clear();
+    v.create_payload<TypedArray<T>>(std::move(values));
+    v.type_ = type;
+    return v;
+  }
+
+  // computes the hash, cacheable is cleared if the value may still be modified through a reference
+  std::size_t hash(bool& cacheable) const
+  {
+    switch (type_) {
+      case Null:
+        break;
+      case Bool:
+        return detail::hash_combine(Bool, *reinterpret_cast<const bool*>(raw_) ? 1 : 0);
+      case Int:
+      case UInt:
+        return detail::hash_combine(Int, *reinterpret_cast<const uint64_t*>(raw_));
+      case Double:
+        return detail::hash_number(*reinterpret_cast<const double*>(raw_));
+      case String:
+        return cached_hash<std::string>(cacheable);
+      case Array:
+        return cached_hash<ArrayType>(cacheable);
+      case Map:
+        return cached_hash<MapType>(cacheable);
+      case Binary:
+        return cached_hash<BinaryType>(cacheable);
+      case DoubleArray:
+        return cached_hash<TypedArray<double>>(cacheable);
+      case FloatArray:
+        return cached_hash<TypedArray<float>>(cacheable);
+      case IntArray:
+        return cached_hash<TypedArray<int64_t>>(cacheable);
+    }
+    return detail::hash_combine(Null, 0);
+  }
+
+  static std::size_t element_hash(double value, bool&)
+  {
+    return detail::hash_number(value);
+  }
+
+  static std::size_t element_hash(float value, bool&)
+  {
+    return detail::hash_number(static_cast<double>(value));
+  }
+
+  static std::size_t element_hash(int64_t value, bool&)
+  {
+    return detail::hash_combine(Int, static_cast<uint64_t>(value));
+  }
+
+  static std::size_t element_hash(const CompactVariant& value, bool& cacheable)
+  {
+    return value.hash(cacheable);
+  }
+
+  static std::size_t compute_hash(const std::string& value, bool&)
+  {
+    return detail::hash_bytes(String, value.data(), value.size());
+  }
+
+  static std::size_t compute_hash(const BinaryType& value, bool&)
+  {
+    return detail::hash_bytes(Binary, value.data(), value.size());
+  }
+
+  static std::size_t compute_hash(const MapType& value, bool& cacheable)
+  {
+    std::size_t seed = detail::hash_combine(Map, value.size());
+    for (const auto& element : value) {
+      seed = detail::hash_bytes(seed, element.first.data(), element.first.size());
+      seed = detail::hash_combine(seed, element.second.hash(cacheable));
+    }
+    return seed;
+  }
+
+  template <typename T>
+  static std::size_t compute_hash(const std::vector<T>& value, bool& cacheable)
+  {
+    // all kinds of arrays hash alike, since typed and generic arrays may compare equal
+    std::size_t seed = detail::hash_combine(Array, value.size());
+    for (const auto& element : value) {
+      seed = detail::hash_combine(seed, element_hash(element, cacheable));
+    }
+    return seed;
+  }
+
+  template <typename T>
+  static std::size_t compute_hash(const TypedArray<T>& value, bool& cacheable)
+  {
+    return compute_hash(value.values_, cacheable);
+  }
+
+  template <typename T>
+  std::size_t cached_hash(bool& cacheable) const
+  {
+    const Payload<T>* p = payload<T>();
+    std::size_t h = p->hash_.load(std::memory_order_relaxed);
+    if (h != 0) {
+      return h;
+    }
+
+    // a value handed out by a mutable accessor may change without the variant noticing, neither its hash nor the
+    // hash of a value containing it is cached
+    bool elements_cacheable = true;
+    h = compute_hash(p->value_, elements_cacheable);
+    if (h == 0) {
+      h = 1;
+    }
+    if (elements_cacheable && !p->exposed_.load(std::memory_order_relaxed)) {
+      p->hash_.store(h, std::memory_order_relaxed);
+    } else {
+      cacheable = false;
+    }
+    return h;
+  }
+
+  template <typename T>
+  bool payload_equals(const CompactVariant& other) const
+  {
+    const Payload<T>* lhs = payload<T>();
+    const Payload<T>* rhs = other.payload<T>();
+    if (lhs == rhs) {
+      return true;
+    }
+    // hashes are only cached for values that cannot be modified through a reference, so they are never stale
+    const std::size_t lhs_hash = lhs->hash_.load(std::memory_order_relaxed);
+    const std::size_t rhs_hash = rhs->hash_.load(std::memory_order_relaxed);
+    if (lhs_hash != 0 && rhs_hash != 0 && lhs_hash != rhs_hash) {
+      return false;
+    }
+    return lhs->value_ == rhs->value_;
+  }
+
+  bool equals(const CompactVariant& other) const
+  {
+    if (this->type() != other.type() && this->is_array() && other.is_array()) {
+      return as_array() == other.as_array();
+    }
+
+    if (this->type() != other.type()) {
+      if (!((this->type() == UInt && other.type() == Int) || (this->type() == Int && other.type() == UInt))) {
+        return false;
+      }
+    }
+
+    switch (type()) {
+      case Null:
+        return true;
+      case Bool:
+        return as_bool() == other.as_bool();
+      case Int:
+        return as_int() == other.as_int();
+      case UInt:
+        return as_uint() == other.as_uint();
+      case Double:
+        return as_double() == other.as_double();
+      case String:
+        return payload_equals<std::string>(other);
+      case Array:
+        return payload_equals<ArrayType>(other);
+      case Map:
+        return payload_equals<MapType>(other);
+      case Binary:
+        return payload_equals<BinaryType>(other);
+      case DoubleArray:
+        return payload_equals<TypedArray<double>>(other);
+      case FloatArray:
+        return payload_equals<TypedArray<float>>(other);
+      case IntArray:
+        return payload_equals<TypedArray<int64_t>>(other);
+    }
+    return false;
+  }
+
+  alignas(uint64_t) char raw_[sizeof(uint64_t)]; // a boolean, a number or the payload pointer
+  VariantType type_;
+};
+
+static_assert(sizeof(void*) <= sizeof(uint64_t), "the payload pointer has to fit into a CompactVariant");
+}
+#ifdef __GNUC__
+#pragma GCC diagnostic pop
+#endif
+}
+
+namespace std
+{
+/// Computes a hash value for CompactVariant.
+template <>
+struct hash<cisco::efm_sdk::CompactVariant>
+{
+  /// Computes a hash value for CompactVariant.
+  /// @param value The variant to compute the hash for.
+  /// @return The computed hash.
+  std::size_t operator()(const cisco::efm_sdk::CompactVariant& value) const
+  {
+    return value.hash();
+  }
+};
+}
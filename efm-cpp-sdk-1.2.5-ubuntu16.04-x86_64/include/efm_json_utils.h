@@ -6,9 +6,17 @@
 
 #pragma once
 
+#include <efm_error_code.h>
+#include <efm_exception.h>
+#include <efm_json_reader.h>
 #include <efm_variant.h>
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <string>
+#include <utility>
+#include <vector>
 
 
 namespace cisco
@@ -17,16 +25,699 @@ namespace efm_sdk
 {
 namespace json
 {
-/// Converts a JSON string into a Variant.
+/// Converts a JSON string into a Variant. See cisco::efm_sdk::json::parse for a header only alternative.
 /// @throw If the string is not a valid JSON document.
 /// @param str A JSON string.
 /// @return The converted Variant.
 cisco::efm_sdk::Variant from_json_string(const std::string& str);
 
-/// Converts a Variant into a JSON string representation.
+/// Converts a Variant into a JSON string representation. To write into a reusable buffer or a sink use
+/// cisco::efm_sdk::json::Writer.
 /// @param variant The Variant to convert.
 /// @return The JSON string of the Variant.
 std::string to_json_string(const cisco::efm_sdk::Variant& variant);
+
+/// @brief Receives the events of cisco::efm_sdk::json::parse_events.
+
+/// Deriving from this class is optional, cisco::efm_sdk::json::parse_events accepts any class providing these member
+/// functions. Every member function returns true to continue parsing or false to stop it.
+class EventHandler
+{
+public:
+  /// Default destructor.
+  virtual ~EventHandler() = default;
+
+  /// Called at the start of a map.
+  /// @return true to continue parsing, false to stop.
+  virtual bool start_map()
+  {
+    return true;
+  }
+
+  /// Called for every key of a map, followed by the events of its value.
+  /// @param key The key. The reference is only valid during the call.
+  /// @return true to continue parsing, false to stop.
+  virtual bool key(const std::string& key)
+  {
+    (void)key;
+    return true;
+  }
+
+  /// Called at the end of a map.
+  /// @return true to continue parsing, false to stop.
+  virtual bool end_map()
+  {
+    return true;
+  }
+
+  /// Called at the start of an array.
+  /// @return true to continue parsing, false to stop.
+  virtual bool start_array()
+  {
+    return true;
+  }
+
+  /// Called at the end of an array.
+  /// @return true to continue parsing, false to stop.
+  virtual bool end_array()
+  {
+    return true;
+  }
+
+  /// Called for every null, bool, number and string value.
+  /// @param value The value.
+  /// @return true to continue parsing, false to stop.
+  virtual bool value(Variant&& value)
+  {
+    (void)value;
+    return true;
+  }
+};
+
+/// @brief Builds a Variant from the events of cisco::efm_sdk::json::parse_events.
+class VariantBuilder
+{
+public:
+  /// Handles the start of a map.
+  /// @return Always true.
+  bool start_map()
+  {
+    stack_.push_back(Frame(true));
+    return true;
+  }
+
+  /// Handles a key of a map.
+  /// @param key The key.
+  /// @return Always true.
+  bool key(const std::string& key)
+  {
+    stack_.back().key_ = key;
+    return true;
+  }
+
+  /// Handles the end of a map.
+  /// @return Always true.
+  bool end_map()
+  {
+    Variant map(efm_sdk::detail::make_map(std::move(stack_.back().members_)));
+    stack_.pop_back();
+    return value(std::move(map));
+  }
+
+  /// Handles the start of an array.
+  /// @return Always true.
+  bool start_array()
+  {
+    stack_.push_back(Frame(false));
+    return true;
+  }
+
+  /// Handles the end of an array.
+  /// @return Always true.
+  bool end_array()
+  {
+    Variant array(std::move(stack_.back().array_));
+    stack_.pop_back();
+    return value(std::move(array));
+  }
+
+  /// Handles a value.
+  /// @param value The value.
+  /// @return Always true.
+  bool value(Variant&& value)
+  {
+    if (stack_.empty()) {
+      result_ = std::move(value);
+    } else if (stack_.back().is_map_) {
+      stack_.back().members_.emplace_back(std::move(stack_.back().key_), std::move(value));
+    } else {
+      stack_.back().array_.push_back(std::move(value));
+    }
+    return true;
+  }
+
+  /// Returns the built variant and resets the builder.
+  /// @return The built variant.
+  Variant take()
+  {
+    Variant result(std::move(result_));
+    result_ = Variant();
+    return result;
+  }
+
+private:
+  struct Frame
+  {
+    explicit Frame(bool is_map)
+      : is_map_(is_map)
+    {
+    }
+
+    bool is_map_;
+    std::string key_;
+    std::vector<std::pair<std::string, Variant>> members_;
+    Variant::ArrayType array_;
+  };
+
+  std::vector<Frame> stack_;
+  Variant result_;
+};
+
+/// @brief Parses a JSON document fed in chunks and reports its structure as events to a handler.
+///
+/// The chunks can be split anywhere, e.g. as they are read from a socket. Every event is reported as soon as the
+/// chunks fed so far contain it completely. Only a string, number or literal split between two chunks is copied and
+/// kept until the next chunk, it is scanned again with every chunk until it is complete. Apart from that, the memory
+/// needed is independent of the size of the document, except for the values the handler keeps.
+///
+/// The handler has to provide the member functions of cisco::efm_sdk::json::EventHandler, but does not need to be
+/// derived from it. cisco::efm_sdk::json::VariantBuilder is a handler building a Variant.
+///
+/// @code
+///     cisco::efm_sdk::json::EventParser<Handler> parser(handler);
+///     while (read(buffer)) {
+///       parser.feed(buffer.data(), buffer.size());
+///     }
+///     parser.finish();
+/// @endcode
+/// @tparam Handler The type of the handler.
+template <typename Handler>
+class EventParser
+{
+public:
+  /// Constructs a parser reporting to the handler.
+  /// @param handler The handler to report the events to. It has to outlive the parser.
+  explicit EventParser(Handler& handler)
+    : handler_(handler)
+  {
+  }
+
+  /// Parses the next chunk of the document.
+  /// @throw cisco::efm_sdk::exception If the data is not valid JSON. Events already reported stay reported, the
+  /// parser cannot be used afterwards.
+  /// @param data The chunk.
+  /// @param size The size of the chunk.
+  /// @return false if the handler stopped parsing, further chunks are ignored then. Otherwise true.
+  bool feed(const char* data, std::size_t size)
+  {
+    if (stopped_) {
+      return false;
+    }
+    if (pending_.empty()) {
+      const std::size_t used = parse(data, size, false);
+      pending_.assign(data + used, size - used);
+    } else {
+      pending_.append(data, size);
+      pending_.erase(0, parse(pending_.data(), pending_.size(), false));
+    }
+    return !stopped_;
+  }
+
+  /// Parses the next chunk of the document, see EventParser::feed(const char*, std::size_t).
+  /// @throw cisco::efm_sdk::exception If the data is not valid JSON.
+  /// @param chunk The chunk.
+  /// @return false if the handler stopped parsing, otherwise true.
+  bool feed(const std::string& chunk)
+  {
+    return feed(chunk.data(), chunk.size());
+  }
+
+  /// Ends the document. Afterwards the parser can be used for the next document.
+  /// @throw cisco::efm_sdk::exception If the document is incomplete.
+  /// @return false if the handler stopped parsing, true if the whole document was parsed.
+  bool finish()
+  {
+    std::string rest;
+    rest.swap(pending_);
+    if (!stopped_) {
+      parse(rest.data(), rest.size(), true);
+    }
+    const bool complete = !stopped_;
+    stack_.clear();
+    state_ = State::value;
+    offset_ = 0;
+    stopped_ = false;
+    return complete;
+  }
+
+private:
+  enum class State
+  {
+    value,          // a value has to follow
+    first_element,  // a value or the end of the array has to follow
+    first_member,   // a key or the end of the map has to follow
+    member,         // a key has to follow
+    colon,          // the colon after a key has to follow
+    next,           // a comma or the end of the enclosing map or array has to follow
+    done            // the document is complete
+  };
+
+  // Parses all tokens the data contains completely and returns the number of bytes consumed. If last is set, the
+  // document ends with the data.
+  std::size_t parse(const char* data, std::size_t size, bool last)
+  {
+    detail::Scanner scanner(data, size, offset_);
+    while (!stopped_ && next(scanner, last)) {
+    }
+    const std::size_t used = static_cast<std::size_t>(scanner.position() - data);
+    offset_ += used;
+    return used;
+  }
+
+  // Parses the next token, returns false if the data ends before it.
+  bool next(detail::Scanner& scanner, bool last)
+  {
+    const char c = scanner.peek();
+    if (c == '\0' && scanner.remaining() == 0) {
+      if (last && state_ != State::done) {
+        scanner.fail("unexpected end of input");
+      }
+      return false;
+    }
+
+    switch (state_) {
+      case State::done:
+        scanner.fail("trailing characters");
+      case State::colon:
+        scanner.expect(':');
+        state_ = State::value;
+        return true;
+      case State::next:
+        if (scanner.consume(',')) {
+          state_ = stack_.back() == '{' ? State::member : State::value;
+          return true;
+        }
+        return close(scanner);
+      case State::first_member:
+        if (c == '}') {
+          return close(scanner);
+        }
+        return key(scanner, last);
+      case State::member:
+        return key(scanner, last);
+      case State::first_element:
+        if (c == ']') {
+          return close(scanner);
+        }
+        return value(scanner, c, last);
+      case State::value:
+        return value(scanner, c, last);
+    }
+    return false;
+  }
+
+  bool key(detail::Scanner& scanner, bool last)
+  {
+    if (!string(scanner, key_, last)) {
+      return false;
+    }
+    state_ = State::colon;
+    stopped_ = !handler_.key(key_);
+    return true;
+  }
+
+  bool value(detail::Scanner& scanner, char c, bool last)
+  {
+    if (stack_.size() > static_cast<std::size_t>(detail::max_depth)) {
+      scanner.fail("nesting too deep");
+    }
+
+    switch (c) {
+      case '{':
+      case '[':
+        scanner.expect(c);
+        stack_.push_back(c);
+        if (c == '{') {
+          state_ = State::first_member;
+          stopped_ = !handler_.start_map();
+        } else {
+          state_ = State::first_element;
+          stopped_ = !handler_.start_array();
+        }
+        return true;
+      case '"': {
+        std::string s;
+        if (!string(scanner, s, last)) {
+          return false;
+        }
+        return scalar(Variant(std::move(s)));
+      }
+      case 't':
+        return literal(scanner, "true", 4, last) && scalar(Variant(true));
+      case 'f':
+        return literal(scanner, "false", 5, last) && scalar(Variant(false));
+      case 'n':
+        return literal(scanner, "null", 4, last) && scalar(Variant());
+      default:
+        if (!last && !scanner.number_terminated()) {
+          return false;
+        }
+        return scalar(scanner.number());
+    }
+  }
+
+  bool close(detail::Scanner& scanner)
+  {
+    const bool is_map = stack_.back() == '{';
+    scanner.expect(is_map ? '}' : ']');
+    stack_.pop_back();
+    completed();
+    stopped_ = !(is_map ? handler_.end_map() : handler_.end_array());
+    return true;
+  }
+
+  bool scalar(Variant&& value)
+  {
+    completed();
+    stopped_ = !handler_.value(std::move(value));
+    return true;
+  }
+
+  void completed()
+  {
+    state_ = stack_.empty() ? State::done : State::next;
+  }
+
+  static bool string(detail::Scanner& scanner, std::string& out, bool last)
+  {
+    if (last) {
+      scanner.string(out);
+      return true;
+    }
+    return scanner.try_string(out);
+  }
+
+  static bool literal(detail::Scanner& scanner, const char* text, std::size_t length, bool last)
+  {
+    if (!last && scanner.remaining() < length) {
+      return false;
+    }
+    scanner.literal(text, length);
+    return true;
+  }
+
+  Handler& handler_;
+  std::string pending_;
+  std::string key_;
+  std::vector<char> stack_;
+  State state_{State::value};
+  std::size_t offset_{0};
+  bool stopped_{false};
+};
+
+/// @private
+namespace detail
+{
+/// Extracts the rows of the "updates" arrays of the responses of a DSA message.
+class UpdateHandler
+{
+public:
+  UpdateHandler(
+    std::function<void(int64_t rid, Variant&& update)> on_update,
+    std::function<void(int64_t rid, Variant&& response)> on_response)
+    : on_update_(std::move(on_update))
+    , on_response_(std::move(on_response))
+  {
+  }
+
+  bool start_map()
+  {
+    return start(true);
+  }
+
+  bool start_array()
+  {
+    return start(false);
+  }
+
+  bool end_map()
+  {
+    return end(true);
+  }
+
+  bool end_array()
+  {
+    return end(false);
+  }
+
+  bool key(const std::string& key)
+  {
+    if (building_ != 0) {
+      builder_.key(key);
+    } else if (depth_ == 1) {
+      root_key_ = key;
+    } else if (depth_ == 3 && in_response_) {
+      response_key_ = key;
+    }
+    return true;
+  }
+
+  bool value(Variant&& value)
+  {
+    if (building_ != 0) {
+      builder_.value(std::move(value));
+    } else if (depth_ == 4 && in_updates_) {
+      update(std::move(value));
+    } else if (depth_ == 3 && in_response_) {
+      if (response_key_ == "rid") {
+        if (!value.try_as_int(rid_) || rid_ < 0) {
+          throw exception(error_code::invalid_value, "the rid of a response is not a non-negative integer");
+        }
+        has_rid_ = true;
+        for (auto& pending : pending_) {
+          on_update_(rid_, std::move(pending));
+        }
+        pending_.clear();
+      }
+      response_[response_key_] = std::move(value);
+    }
+    return true;
+  }
+
+private:
+  bool start(bool is_map)
+  {
+    ++depth_;
+    if (building_ != 0) {
+      ++building_;
+    } else if (depth_ == 2 && !is_map && root_key_ == "responses") {
+      in_responses_ = true;
+    } else if (depth_ == 3 && is_map && in_responses_) {
+      in_response_ = true;
+      response_.clear();
+      rid_ = 0;
+      has_rid_ = false;
+    } else if (depth_ == 4 && in_response_ && !is_map && response_key_ == "updates") {
+      in_updates_ = true;
+    } else if ((depth_ == 4 && in_response_) || (depth_ == 5 && in_updates_)) {
+      building_ = 1;
+    }
+
+    if (building_ != 0) {
+      is_map ? builder_.start_map() : builder_.start_array();
+    }
+    return true;
+  }
+
+  bool end(bool is_map)
+  {
+    if (building_ != 0) {
+      is_map ? builder_.end_map() : builder_.end_array();
+      if (--building_ == 0) {
+        if (in_updates_) {
+          update(builder_.take());
+        } else {
+          response_[response_key_] = builder_.take();
+        }
+      }
+    } else if (depth_ == 4 && in_updates_) {
+      in_updates_ = false;
+    } else if (depth_ == 3 && in_response_) {
+      in_response_ = false;
+      for (auto& pending : pending_) {
+        on_update_(rid_, std::move(pending));
+      }
+      pending_.clear();
+      if (on_response_) {
+        on_response_(rid_, Variant(std::move(response_)));
+      }
+      response_ = Variant::MapType();
+    } else if (depth_ == 2) {
+      in_responses_ = false;
+    }
+    --depth_;
+    return true;
+  }
+
+  void update(Variant&& row)
+  {
+    if (has_rid_) {
+      on_update_(rid_, std::move(row));
+    } else {
+      pending_.push_back(std::move(row));
+    }
+  }
+
+  std::function<void(int64_t rid, Variant&& update)> on_update_;
+  std::function<void(int64_t rid, Variant&& response)> on_response_;
+  VariantBuilder builder_;
+  int building_{0};
+  int depth_{0};
+  bool in_responses_{false};
+  bool in_response_{false};
+  bool in_updates_{false};
+  std::string root_key_;
+  std::string response_key_;
+  Variant::MapType response_;
+  int64_t rid_{0};
+  bool has_rid_{false};
+  std::vector<Variant> pending_;
+};
+}
+
+/// Parses a complete JSON document and reports its structure as events to the handler, without building a Variant
+/// for the whole document. To parse a document in chunks use cisco::efm_sdk::json::EventParser.
+///
+/// The handler has to provide the member functions of cisco::efm_sdk::json::EventHandler, but does not need to be
+/// derived from it. cisco::efm_sdk::json::VariantBuilder is a handler building a Variant.
+/// @throw cisco::efm_sdk::exception If the data is not a valid JSON document. Events already reported stay reported.
+/// @tparam Handler The type of the handler.
+/// @param data The JSON document.
+/// @param size The size of the JSON document.
+/// @param handler The handler to report the events to.
+/// @return true if the whole document was parsed, false if the handler stopped parsing.
+template <typename Handler>
+bool parse_events(const char* data, std::size_t size, Handler& handler)
+{
+  EventParser<Handler> parser(handler);
+  return parser.feed(data, size) && parser.finish();
+}
+
+/// Parses a complete JSON document and reports its structure as events to the handler, see
+/// cisco::efm_sdk::json::parse_events(const char*, std::size_t, Handler&).
+/// @throw cisco::efm_sdk::exception If the string is not a valid JSON document.
+/// @tparam Handler The type of the handler.
+/// @param str The JSON document.
+/// @param handler The handler to report the events to.
+/// @return true if the whole document was parsed, false if the handler stopped parsing.
+template <typename Handler>
+bool parse_events(const std::string& str, Handler& handler)
+{
+  return parse_events(str.data(), str.size(), handler);
+}
+
+/// @brief Parses DSA messages fed in chunks and reports every row of the `updates` of their responses (e.g. list
+/// updates or invoke table rows) as soon as the row is complete.
+///
+/// Only one row is built as Variant at a time, instead of a Variant for the whole message, and the message does not
+/// have to be held in memory (see cisco::efm_sdk::json::EventParser). The parser is meant for messages the
+/// application reads itself, e.g. from a recorded session or its own connection. cisco::efm_sdk::Requester does not
+/// use it, the SDK library parses the messages it receives.
+///
+/// @code
+///     cisco::efm_sdk::json::UpdateParser parser([&table](int64_t rid, cisco::efm_sdk::Variant&& row) {
+///       table.append(std::move(row));
+///     });
+///     while (read(buffer)) {
+///       parser.feed(buffer.data(), buffer.size());
+///     }
+///     parser.finish();
+/// @endcode
+class UpdateParser
+{
+public:
+  /// Constructs a parser reporting to the callbacks.
+  /// @param on_update Called with the request id and the row for every row. Rows preceding the `rid` of their
+  /// response are held back until the `rid` is known.
+  /// @param on_response Optional, called at the end of every response with the request id and the fields of the
+  /// response except `updates` (e.g. `stream`, `columns` or `meta`).
+  explicit UpdateParser(
+    std::function<void(int64_t rid, Variant&& update)> on_update,
+    std::function<void(int64_t rid, Variant&& response)> on_response = nullptr)
+    : handler_(std::move(on_update), std::move(on_response))
+    , parser_(handler_)
+  {
+  }
+
+  /// This class is not copyable
+  UpdateParser(const UpdateParser&) = delete;
+
+  /// This class is not assignable
+  /// @return A reference to the UpdateParser object
+  UpdateParser& operator=(const UpdateParser&) = delete;
+
+  /// Parses the next chunk of the message.
+  /// @throw cisco::efm_sdk::exception If the data is not valid JSON or the `rid` of a response is not a non-negative
+  /// integer. Rows already reported stay reported, the parser cannot be used afterwards.
+  /// @param data The chunk.
+  /// @param size The size of the chunk.
+  void feed(const char* data, std::size_t size)
+  {
+    parser_.feed(data, size);
+  }
+
+  /// Parses the next chunk of the message, see UpdateParser::feed(const char*, std::size_t).
+  /// @throw cisco::efm_sdk::exception If the data is not valid JSON or the `rid` of a response is invalid.
+  /// @param chunk The chunk.
+  void feed(const std::string& chunk)
+  {
+    parser_.feed(chunk.data(), chunk.size());
+  }
+
+  /// Ends the message. Afterwards the parser can be used for the next message.
+  /// @throw cisco::efm_sdk::exception If the message is incomplete.
+  void finish()
+  {
+    parser_.finish();
+  }
+
+private:
+  detail::UpdateHandler handler_;
+  EventParser<detail::UpdateHandler> parser_;
+};
+
+/// Parses a complete DSA message and reports every row of the `updates` of its responses, see
+/// cisco::efm_sdk::json::UpdateParser.
+///
+/// @code
+///     cisco::efm_sdk::json::parse_updates(message, [&table](int64_t rid, cisco::efm_sdk::Variant&& row) {
+///       table.append(std::move(row));
+///     });
+/// @endcode
+///
+/// @throw cisco::efm_sdk::exception If the data is not a valid JSON document or the `rid` of a response is not a
+/// non-negative integer. Rows already reported stay reported.
+/// @param data The complete DSA message.
+/// @param size The size of the DSA message.
+/// @param on_update Called with the request id and the row for every row. Rows preceding the `rid` of their response
+/// are held back until the `rid` is known.
+/// @param on_response Optional, called at the end of every response with the request id and the fields of the
+/// response except `updates` (e.g. `stream`, `columns` or `meta`).
+inline void parse_updates(
+  const char* data,
+  std::size_t size,
+  std::function<void(int64_t rid, Variant&& update)> on_update,
+  std::function<void(int64_t rid, Variant&& response)> on_response = nullptr)
+{
+  UpdateParser parser(std::move(on_update), std::move(on_response));
+  parser.feed(data, size);
+  parser.finish();
+}
+
+/// Parses a complete DSA message and reports every row of the `updates` of its responses, see
+/// cisco::efm_sdk::json::UpdateParser.
+/// @throw cisco::efm_sdk::exception If the string is not a valid JSON document or the `rid` of a response is invalid.
+/// @param str The complete DSA message.
+/// @param on_update Called with the request id and the row for every row.
+/// @param on_response Optional, called at the end of every response with the request id and the fields of the
+/// response except `updates`.
+inline void parse_updates(
+  const std::string& str,
+  std::function<void(int64_t rid, Variant&& update)> on_update,
+  std::function<void(int64_t rid, Variant&& response)> on_response = nullptr)
+{
+  parse_updates(str.data(), str.size(), std::move(on_update), std::move(on_response));
+}
 }
 }
 }
@@ -0,0 +1,262 @@
+// @copyright_start
+// Copyright (c) 2018-2019 Cisco and/or its affiliates. All rights reserved.
+// @copyright_end
+
+/// @file efm_json_writer.h
+
+#pragma once
+
+#include <efm_base64.h>
+#include <efm_number_format.h>
+#include <efm_variant.h>
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <utility>
+
+namespace cisco
+{
+namespace efm_sdk
+{
+namespace json
+{
+/// @brief Writes variants as JSON into a reusable buffer or a sink.
+
+/// The writer appends the JSON representation of variants directly to a buffer, no intermediate strings are created
+/// for nested values. Doubles are written with the shortest representation that parses back to the identical value
+/// (see cisco::efm_sdk::number::format_double). Values of type Variant::Binary are encoded as DSA binary string (see
+/// cisco::efm_sdk::encode_dsa_binary).
+///
+/// Writing into a caller owned buffer allows to reuse its capacity for many values:
+/// @code
+///     std::string buffer;
+///     cisco::efm_sdk::json::Writer writer(buffer);
+///     for (const auto& value : values) {
+///       buffer.clear();
+///       writer.write(value);
+///       send(buffer);
+///     }
+/// @endcode
+///
+/// Writing to a sink hands the output over in chunks of about the given size, which keeps the memory bounded for
+/// large documents:
+/// @code
+///     std::ofstream file("nodes.json");
+///     cisco::efm_sdk::json::Writer writer([&file](const char* data, std::size_t size) { file.write(data, size); });
+///     writer.write(nodes);
+///     writer.flush();
+/// @endcode
+class Writer
+{
+public:
+  /// The sink the output is handed over to.
+  using Sink = std::function<void(const char* data, std::size_t size)>;
+
+  /// Constructs a writer appending to the given buffer. The buffer has to outlive the writer.
+  /// @param buffer The buffer to append to.
+  explicit Writer(std::string& buffer)
+    : out_(buffer)
+  {
+  }
+
+  /// Constructs a writer handing over the output to a sink. The output is collected in an internal buffer and handed
+  /// over whenever it exceeds the chunk size and on Writer::flush.
+  /// @param sink The sink to hand the output over to.
+  /// @param chunk_size The size of the chunks handed over to the sink.
+  explicit Writer(Sink sink, std::size_t chunk_size = 16 * 1024)
+    : out_(buffer_)
+    , sink_(std::move(sink))
+    , chunk_size_(chunk_size)
+  {
+    buffer_.reserve(chunk_size_ + number::max_formatted_length);
+  }
+
+  /// This class is not copyable
+  Writer(const Writer&) = delete;
+  /// This class is not assignable
+  /// @return A reference to the Writer object
+  Writer& operator=(const Writer&) = delete;
+
+  /// Writes the JSON representation of a variant.
+  /// @param value The variant to write.
+  void write(const Variant& value)
+  {
+    write_value(value);
+    flush_if_full();
+  }
+
+  /// Writes a string as JSON string, escaping it as necessary.
+  /// @param value The string to write.
+  void write_string(const std::string& value)
+  {
+    write_string(value.data(), value.size());
+  }
+
+  /// Writes a string as JSON string, escaping it as necessary.
+  /// @param data The characters of the string.
+  /// @param size The number of characters.
+  void write_string(const char* data, std::size_t size)
+  {
+    static const char hex[] = "0123456789abcdef";
+
+    out_ += '"';
+    std::size_t start = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+      const unsigned char c = static_cast<unsigned char>(data[i]);
+      if (c >= 0x20 && c != '"' && c != '\\') {
+        continue;
+      }
+      out_.append(data + start, i - start);
+      start = i + 1;
+      switch (c) {
+        case '"':
+          out_.append("\\\"", 2);
+          break;
+        case '\\':
+          out_.append("\\\\", 2);
+          break;
+        case '\b':
+          out_.append("\\b", 2);
+          break;
+        case '\f':
+          out_.append("\\f", 2);
+          break;
+        case '\n':
+          out_.append("\\n", 2);
+          break;
+        case '\r':
+          out_.append("\\r", 2);
+          break;
+        case '\t':
+          out_.append("\\t", 2);
+          break;
+        default: {
+          const char escaped[] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF]};
+          out_.append(escaped, sizeof(escaped));
+          break;
+        }
+      }
+    }
+    out_.append(data + start, size - start);
+    out_ += '"';
+  }
+
+  /// Hands over the collected output to the sink. Does nothing if the writer appends to a caller owned buffer.
+  void flush()
+  {
+    if (sink_ && !buffer_.empty()) {
+      sink_(buffer_.data(), buffer_.size());
+      buffer_.clear();
+    }
+  }
+
+private:
+  void write_value(const Variant& value)
+  {
+    char number[number::max_formatted_length];
+    switch (value.type()) {
+      case Variant::Null:
+        out_.append("null", 4);
+        break;
+      case Variant::Bool:
+        if (value.as_bool()) {
+          out_.append("true", 4);
+        } else {
+          out_.append("false", 5);
+        }
+        break;
+      case Variant::Int:
+        out_.append(number, number::format_int(value.as_int(), number));
+        break;
+      case Variant::UInt:
+        out_.append(number, number::format_uint(value.as_uint(), number));
+        break;
+      case Variant::Double:
+        out_.append(number, number::format_double(value.as_double(), number));
+        break;
+      case Variant::String:
+        write_string(value.as_string());
+        break;
+      case Variant::Binary: {
+        const Variant::BinaryType& binary = value.as_binary();
+        out_.append("\"\\u001Bbytes:", 13);
+        base64::encode(binary.data(), binary.size(), out_);
+        out_ += '"';
+        break;
+      }
+      case Variant::Map: {
+        out_ += '{';
+        bool first{true};
+        for (const auto& element : value.as_map()) {
+          if (!first) {
+            out_ += ',';
+          }
+          first = false;
+          write_string(element.first);
+          out_ += ':';
+          write_value(element.second);
+          flush_if_full();
+        }
+        out_ += '}';
+        break;
+      }
+      case Variant::Array: {
+        out_ += '[';
+        bool first{true};
+        for (const auto& element : value.as_array()) {
+          if (!first) {
+            out_ += ',';
+          }
+          first = false;
+          write_value(element);
+          flush_if_full();
+        }
+        out_ += ']';
+        break;
+      }
+      case Variant::DoubleArray:
+        write_list(value.as_double_array());
+        break;
+      case Variant::FloatArray:
+        write_list(value.as_float_array());
+        break;
+      case Variant::IntArray:
+        write_list(value.as_int_array());
+        break;
+    }
+  }
+
+  template <typename T>
+  void write_list(const std::vector<T>& values)
+  {
+    out_ += '[';
+    number::append_list(values.data(), values.size(), out_);
+    out_ += ']';
+  }
+
+  void flush_if_full()
+  {
+    if (sink_ && buffer_.size() >= chunk_size_) {
+      flush();
+    }
+  }
+
+  std::string buffer_;
+  std::string& out_;
+  Sink sink_;
+  std::size_t chunk_size_{0};
+};
+
+/// Appends the JSON representation of a variant to a string. Unlike cisco::efm_sdk::json::to_json_string the
+/// capacity of the string can be reused for many values.
+/// @param value The variant to write.
+/// @param out The string to append to.
+inline void append_json(const Variant& value, std::string& out)
+{
+  Writer writer(out);
+  writer.write(value);
+}
+}
+}
+}
@@ -0,0 +1,320 @@
+// @copyright_start
+// Copyright (c) 2018-2019 Cisco and/or its affiliates. All rights reserved.
+// @copyright_end
+
+/// @file efm_path_pattern.h
+
+#pragma once
+
+#include <efm_node_path.h>
+#include <efm_string_view.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace cisco
+{
+namespace efm_sdk
+{
+/// @private
+namespace detail
+{
+/// Matches a path segment against a pattern segment with `*` (any characters) and `?` (one character) wildcards.
+inline bool glob_match(StringView pattern, StringView segment) noexcept
+{
+  std::size_t p = 0;
+  std::size_t s = 0;
+  std::size_t star = StringView::npos;
+  std::size_t star_s = 0;
+  while (s < segment.size()) {
+    if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == segment[s])) {
+      ++p;
+      ++s;
+    } else if (p < pattern.size() && pattern[p] == '*') {
+      star = p++;
+      star_s = s;
+    } else if (star != StringView::npos) {
+      p = star + 1;
+      s = ++star_s;
+    } else {
+      return false;
+    }
+  }
+  while (p < pattern.size() && pattern[p] == '*') {
+    ++p;
+  }
+  return p == pattern.size();
+}
+}
+
+/// @brief Matches node paths against many path patterns in a single pass.
+
+/// The patterns are compiled into a trie of path segments. Matching a path walks the trie once, following all
+/// branches the path can take in parallel, so the cost depends on the depth of the path and not on the number of
+/// patterns. The wildcards are segment based:
+///
+/// - `*` as a whole segment matches exactly one segment, e.g. `/nodes/*` matches the children of `/nodes`
+/// - `**` as a whole segment matches any number of segments (including none), e.g. `/devices/**/temperature`
+/// - `*` and `?` within a segment match any characters and a single character, e.g. `/sensors/room-?/temp*`
+///
+/// Patterns have to start with `/` and must not contain empty segments.
+///
+/// @note This differs from the patterns of Responder::add_node_creation_callback, where `*` also matches `/`: there
+/// `/nodes/*` matches all descendants of `/nodes`, e.g. `/nodes/X/add_node`. The equivalent pattern of this matcher
+/// is `/nodes/*/**`. Wildcards within a segment never match across segments here.
+///
+/// @code
+///     cisco::efm_sdk::PathPatternMatcher<int> matcher;
+///     matcher.insert("/nodes/*", 1);
+///     matcher.insert("/devices/**/temperature", 2);
+///     matcher.match("/devices/plant-a/line-1/temperature", [](const std::string& pattern, const int& id) {
+///       // called once with "/devices/**/temperature" and 2
+///     });
+/// @endcode
+///
+/// @tparam T The type of the value stored for every pattern, e.g. a callback.
+template <typename T>
+class PathPatternMatcher
+{
+public:
+  /// Constructs an empty matcher.
+  PathPatternMatcher()
+    : root_(new Node)
+  {
+  }
+
+  /// Checks if a pattern is valid.
+  /// @param pattern The pattern to check.
+  /// @return true if the pattern is valid, false otherwise.
+  static bool is_valid(const std::string& pattern)
+  {
+    if (pattern.empty() || pattern[0] != '/') {
+      return false;
+    }
+    if (pattern.size() == 1) {
+      return true;
+    }
+    for (std::size_t i = 1; i < pattern.size(); ++i) {
+      if (pattern[i] == '/' && pattern[i - 1] == '/') {
+        return false;
+      }
+    }
+    return pattern.back() != '/';
+  }
+
+  /// Adds a pattern. If the pattern already exists its value is replaced.
+  /// @param pattern The pattern to add.
+  /// @param value The value to store for the pattern.
+  /// @return true if the pattern was added, false if the pattern is invalid.
+  bool insert(const std::string& pattern, T value)
+  {
+    if (!is_valid(pattern)) {
+      return false;
+    }
+
+    const NodePath path(pattern);
+    Node* node = root_.get();
+    for (StringView segment : path.segments()) {
+      node = node->child(segment);
+    }
+    if (!node->entry_) {
+      ++size_;
+    }
+    node->entry_.reset(new Entry{pattern, std::move(value)});
+    return true;
+  }
+
+  /// Removes a pattern.
+  /// @param pattern The pattern to remove.
+  /// @return true if the pattern was removed, false if it did not exist.
+  bool erase(const std::string& pattern)
+  {
+    if (!is_valid(pattern)) {
+      return false;
+    }
+
+    const NodePath path(pattern);
+    Node* node = root_.get();
+    for (StringView segment : path.segments()) {
+      node = node->find_child(segment);
+      if (node == nullptr) {
+        return false;
+      }
+    }
+    if (!node->entry_) {
+      return false;
+    }
+    node->entry_.reset();
+    --size_;
+    return true;
+  }
+
+  /// Returns the number of patterns.
+  /// @return The number of patterns.
+  std::size_t size() const noexcept
+  {
+    return size_;
+  }
+
+  /// Checks if there are no patterns.
+  /// @return true if there are no patterns, otherwise false.
+  bool empty() const noexcept
+  {
+    return size_ == 0;
+  }
+
+  /// Calls a function for every pattern matching the path. Every matching pattern is reported once, in no particular
+  /// order.
+  /// @tparam Function A callable with the signature `void(const std::string& pattern, const T& value)`.
+  /// @param path The path to match.
+  /// @param on_match The function to call for every matching pattern.
+  template <typename Function>
+  void match(const NodePath& path, Function&& on_match) const
+  {
+    std::vector<const Node*> states;
+    std::vector<const Node*> next;
+    add_state(root_.get(), states);
+
+    for (StringView segment : path.segments()) {
+      next.clear();
+      for (const Node* state : states) {
+        state->advance(segment, next);
+      }
+      states.swap(next);
+      if (states.empty()) {
+        return;
+      }
+    }
+
+    for (const Node* state : states) {
+      if (state->entry_) {
+        on_match(state->entry_->pattern_, state->entry_->value_);
+      }
+    }
+  }
+
+  /// Checks if any pattern matches the path.
+  /// @param path The path to match.
+  /// @return true if at least one pattern matches, otherwise false.
+  bool matches(const NodePath& path) const
+  {
+    bool matched = false;
+    match(path, [&matched](const std::string&, const T&) { matched = true; });
+    return matched;
+  }
+
+private:
+  struct Entry
+  {
+    std::string pattern_;
+    T value_;
+  };
+
+  struct Node
+  {
+    using Children = std::vector<std::pair<std::string, std::unique_ptr<Node>>>;
+
+    // literal segments sorted by name
+    Children literals_;
+    // segments containing wildcards
+    Children globs_;
+    // `*`
+    std::unique_ptr<Node> any_;
+    // `**`
+    std::unique_ptr<Node> any_depth_;
+    bool is_any_depth_{false};
+    std::unique_ptr<Entry> entry_;
+
+    static bool less(const typename Children::value_type& child, StringView segment)
+    {
+      return StringView(child.first) < segment;
+    }
+
+    Node* child(StringView segment)
+    {
+      if (segment == "**") {
+        if (!any_depth_) {
+          any_depth_.reset(new Node);
+          any_depth_->is_any_depth_ = true;
+        }
+        return any_depth_.get();
+      }
+      if (segment == "*") {
+        if (!any_) {
+          any_.reset(new Node);
+        }
+        return any_.get();
+      }
+      if (segment.find('*') != StringView::npos || segment.find('?') != StringView::npos) {
+        for (auto& glob : globs_) {
+          if (StringView(glob.first) == segment) {
+            return glob.second.get();
+          }
+        }
+        globs_.emplace_back(segment.to_string(), std::unique_ptr<Node>(new Node));
+        return globs_.back().second.get();
+      }
+      auto it = std::lower_bound(literals_.begin(), literals_.end(), segment, &less);
+      if (it == literals_.end() || StringView(it->first) != segment) {
+        it = literals_.emplace(it, segment.to_string(), std::unique_ptr<Node>(new Node));
+      }
+      return it->second.get();
+    }
+
+    Node* find_child(StringView segment) const
+    {
+      if (segment == "**") {
+        return any_depth_.get();
+      }
+      if (segment == "*") {
+        return any_.get();
+      }
+      for (const auto& glob : globs_) {
+        if (StringView(glob.first) == segment) {
+          return glob.second.get();
+        }
+      }
+      const auto it = std::lower_bound(literals_.begin(), literals_.end(), segment, &less);
+      return it != literals_.end() && StringView(it->first) == segment ? it->second.get() : nullptr;
+    }
+
+    void advance(StringView segment, std::vector<const Node*>& next) const
+    {
+      if (is_any_depth_) {
+        add_state(this, next);
+      }
+      const auto it = std::lower_bound(literals_.begin(), literals_.end(), segment, &less);
+      if (it != literals_.end() && StringView(it->first) == segment) {
+        add_state(it->second.get(), next);
+      }
+      for (const auto& glob : globs_) {
+        if (detail::glob_match(glob.first, segment)) {
+          add_state(glob.second.get(), next);
+        }
+      }
+      if (any_) {
+        add_state(any_.get(), next);
+      }
+    }
+  };
+
+  // adds a state and the states reachable without consuming a segment (`**` matching no segment)
+  static void add_state(const Node* node, std::vector<const Node*>& states)
+  {
+    for (; node != nullptr; node = node->any_depth_.get()) {
+      if (std::find(states.begin(), states.end(), node) != states.end()) {
+        return;
+      }
+      states.push_back(node);
+    }
+  }
+
+  std::unique_ptr<Node> root_;
+  std::size_t size_{0};
+};
+}
+}
@@ -6,10 +6,15 @@
 
 #pragma once
 
+#include <efm_base64.h>
+#include <efm_error_code.h>
+#include <efm_exception.h>
 #include <efm_variant.h>
 
+#include <algorithm>
+#include <cstddef>
 #include <string>
-
+#include <vector>
 
 namespace cisco
 {
@@ -27,10 +32,74 @@ std::string string_escape(const std::string& s);
 /// @return The DSA encoded binary.
 std::string encode_dsa_binary(const std::vector<unsigned char>& bytes);
 
+/// @private
+static const char dsa_binary_prefix[] = "\x1B" "bytes:";
+
+/// Encodes bytes into a DSA binary and appends it to a string. A DSA binary has a prefix of "\u001Bbytes:" and is
+/// Base64 encoded. The capacity of the string can be reused for many binaries.
+/// @param data The bytes to encode.
+/// @param size The number of bytes to encode.
+/// @param out The string to append the DSA binary to.
+inline void encode_dsa_binary(const unsigned char* data, std::size_t size, std::string& out)
+{
+  const std::size_t prefix_size = sizeof(dsa_binary_prefix) - 1;
+  const std::size_t pos = out.size();
+  out.resize(pos + prefix_size + base64::encoded_size(size));
+  std::copy(dsa_binary_prefix, dsa_binary_prefix + prefix_size, &out[pos]);
+  base64::encode(data, size, &out[pos + prefix_size]);
+}
+
+/// Encodes a binary buffer into a DSA binary. A DSA binary has a prefix of "\u001Bbytes:" and is Base64 encoded.
+/// @param bytes The buffer to encode.
+/// @return The DSA encoded binary.
+inline std::string encode_dsa_binary(const BinaryBuffer& bytes)
+{
+  std::string encoded;
+  encode_dsa_binary(bytes.data(), bytes.size(), encoded);
+  return encoded;
+}
+
 /// Decodes a DSA binary. A DSA binary has a prefix of "\u001Bbytes:" and is Base64 encoded.
 /// @throw If the buffer cannot be decoded.
 /// @param bytes The buffer to decode.
 /// @return The decoded binary.
 std::vector<unsigned char> decode_dsa_binary(const std::string& bytes);
+
+/// @private
+inline std::size_t dsa_binary_payload(const char* data, std::size_t size)
+{
+  const std::size_t prefix_size = sizeof(dsa_binary_prefix) - 1;
+  if (size < prefix_size || !std::equal(dsa_binary_prefix, dsa_binary_prefix + prefix_size, data)) {
+    throw exception(error_code::invalid_value, "not a DSA binary");
+  }
+  return prefix_size;
+}
+
+/// Decodes a DSA binary into a caller supplied buffer. Missing Base64 padding is accepted.
+/// @throw cisco::efm_sdk::exception If the data is not a valid DSA binary or the buffer is too small.
+/// @param data The DSA binary to decode.
+/// @param size The length of the DSA binary.
+/// @param out The buffer to write to.
+/// @param capacity The size of the buffer.
+/// @return The number of decoded bytes.
+inline std::size_t decode_dsa_binary(const char* data, std::size_t size, unsigned char* out, std::size_t capacity)
+{
+  const std::size_t offset = dsa_binary_payload(data, size);
+  if (base64::decoded_size(data + offset, size - offset) > capacity) {
+    throw exception(error_code::invalid_value, "buffer too small for DSA binary");
+  }
+  return static_cast<std::size_t>(base64::decode(data + offset, size - offset, out) - out);
+}
+
+/// Decodes a DSA binary and appends the bytes to a vector. Missing Base64 padding is accepted. The capacity of the
+/// vector can be reused for many binaries.
+/// @throw cisco::efm_sdk::exception If the data is not a valid DSA binary.
+/// @param bytes The DSA binary to decode.
+/// @param out The vector to append the decoded bytes to.
+inline void decode_dsa_binary(const std::string& bytes, std::vector<unsigned char>& out)
+{
+  const std::size_t offset = dsa_binary_payload(bytes.data(), bytes.size());
+  base64::decode(bytes.data() + offset, bytes.size() - offset, out);
+}
 }
 }
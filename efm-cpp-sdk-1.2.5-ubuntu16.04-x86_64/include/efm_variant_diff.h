@@ -0,0 +1,127 @@
+// @copyright_start
+// Copyright (c) 2018-2019 Cisco and/or its affiliates. All rights reserved.
+// @copyright_end
+
+/// @file efm_variant_diff.h
+
+#pragma once
+
+#include <efm_variant.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace cisco
+{
+namespace efm_sdk
+{
+
+/// @brief The differences between two variants as computed by cisco::efm_sdk::diff.
+struct VariantDiff
+{
+  bool replaced_{false};                     ///< The value was replaced as a whole (different type or scalar value)
+  std::vector<std::string> changed_keys_;    ///< Map keys that were added or whose value changed
+  std::vector<std::string> removed_keys_;    ///< Map keys that were removed
+  std::vector<std::size_t> changed_indices_; ///< Array indices that were added or whose value changed
+  std::vector<std::size_t> removed_indices_; ///< Array indices that were removed from the end of the array
+
+  /// Checks if the compared variants are equal.
+  /// @return true if there are no differences, otherwise false.
+  bool empty() const
+  {
+    return !replaced_ && changed_keys_.empty() && removed_keys_.empty() && changed_indices_.empty() &&
+           removed_indices_.empty();
+  }
+};
+
+/// @private
+namespace detail
+{
+template <typename Array>
+void diff_arrays(const Array& old_array, const Array& new_array, VariantDiff& result)
+{
+  const std::size_t common = std::min(old_array.size(), new_array.size());
+  for (std::size_t i = 0; i < common; ++i) {
+    if (!(old_array[i] == new_array[i])) {
+      result.changed_indices_.push_back(i);
+    }
+  }
+  for (std::size_t i = common; i < new_array.size(); ++i) {
+    result.changed_indices_.push_back(i);
+  }
+  for (std::size_t i = common; i < old_array.size(); ++i) {
+    result.removed_indices_.push_back(i);
+  }
+}
+
+inline void diff_maps(const Variant::MapType& old_map, const Variant::MapType& new_map, VariantDiff& result)
+{
+  // both maps are sorted by key, so a single merge walk finds all differences
+  auto old_it = old_map.begin();
+  auto new_it = new_map.begin();
+  while (old_it != old_map.end() && new_it != new_map.end()) {
+    if (old_it->first < new_it->first) {
+      result.removed_keys_.push_back(old_it->first);
+      ++old_it;
+    } else if (new_it->first < old_it->first) {
+      result.changed_keys_.push_back(new_it->first);
+      ++new_it;
+    } else {
+      if (old_it->second != new_it->second) {
+        result.changed_keys_.push_back(new_it->first);
+      }
+      ++old_it;
+      ++new_it;
+    }
+  }
+  for (; old_it != old_map.end(); ++old_it) {
+    result.removed_keys_.push_back(old_it->first);
+  }
+  for (; new_it != new_map.end(); ++new_it) {
+    result.changed_keys_.push_back(new_it->first);
+  }
+}
+}
+
+/// Computes the differences between two variants. Maps are compared key by key and arrays index by index, one level
+/// deep. Nested values are compared as a whole.
+///
+/// This allows to skip publishing unchanged composite values or to send only the changed parts of large maps:
+/// @code
+///     auto changes = cisco::efm_sdk::diff(last_value, value);
+///     if (!changes.empty()) {
+///       responder->set_value(path, value, [](const std::error_code&) {});
+///       last_value = value;
+///     }
+/// @endcode
+///
+/// @param old_value The previous value.
+/// @param new_value The current value.
+/// @return The differences. If the types of the variants differ (except for typed and generic arrays) or a scalar
+/// value changed, VariantDiff::replaced_ is set.
+inline VariantDiff diff(const Variant& old_value, const Variant& new_value)
+{
+  VariantDiff result;
+  if (old_value == new_value) {
+    return result;
+  }
+
+  if (old_value.type() == Variant::Map && new_value.type() == Variant::Map) {
+    detail::diff_maps(old_value.as_map(), new_value.as_map(), result);
+  } else if (old_value.type() == Variant::DoubleArray && new_value.type() == Variant::DoubleArray) {
+    detail::diff_arrays(old_value.as_double_array(), new_value.as_double_array(), result);
+  } else if (old_value.type() == Variant::FloatArray && new_value.type() == Variant::FloatArray) {
+    detail::diff_arrays(old_value.as_float_array(), new_value.as_float_array(), result);
+  } else if (old_value.type() == Variant::IntArray && new_value.type() == Variant::IntArray) {
+    detail::diff_arrays(old_value.as_int_array(), new_value.as_int_array(), result);
+  } else if (old_value.is_array() && new_value.is_array()) {
+    detail::diff_arrays(old_value.as_array(), new_value.as_array(), result);
+  } else {
+    result.replaced_ = true;
+  }
+  return result;
+}
+}
+}